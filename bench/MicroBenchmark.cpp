@@ -0,0 +1,355 @@
+/**
+ * @file MicroBenchmark.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * Time the hot paths of Environment and GraphManager, one line per
+ * benchmark in CSV, or a JSON document :
+ *
+ *   Millenium-Cell-bench [csv|json] [minimum seconds per benchmark]
+ */
+
+/* std include */
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* boost include */
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/graph/adjacency_list.hpp>
+
+/* project include */
+#include "environment.h"
+#include "GraphManager.hpp"
+#include "AllocationCounter.hpp"
+
+/* grid and thresholds of the simulation of main */
+static const unsigned int width = 10;
+static const unsigned int height = 10;
+static const unsigned int maxCell = 7;
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Measure of a benchmark
+ */
+/* -----------------------------------------------------------*/
+struct BenchmarkResult
+{
+  std::string name;
+  std::size_t iterations;
+  double nsPerOp;
+  double allocationsPerOp;
+  double opsPerSecond;
+};
+
+static double elapsedSeconds(
+    const boost::posix_time::ptime &start,
+    const boost::posix_time::ptime &stop)
+{
+  return (stop - start).total_microseconds() * 1e-6;
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Run op(i) for i in [0, n), doubling n until the loop lasts at least
+ * minSeconds
+ *
+ * @param name : name of the benchmark
+ * @param op : functor, called once per operation
+ * @param minSeconds : minimum duration of the measured loop
+ */
+/* -----------------------------------------------------------*/
+template<class Operation>
+BenchmarkResult measure(
+    const std::string &name,
+    Operation &op,
+    double minSeconds)
+{
+  BenchmarkResult result;
+  result.name = name;
+  for (std::size_t n = 1; ; n *= 2)
+  {
+    std::size_t allocations = AllocationCounter::getNbAllocations();
+    boost::posix_time::ptime start =
+      boost::posix_time::microsec_clock::universal_time();
+    for (std::size_t i = 0; i < n; i++) op(i);
+    boost::posix_time::ptime stop =
+      boost::posix_time::microsec_clock::universal_time();
+    allocations = AllocationCounter::getNbAllocations() - allocations;
+
+    double seconds = elapsedSeconds(start, stop);
+    if (seconds >= minSeconds || n >= (std::size_t(1) << 40))
+    {
+      result.iterations = n;
+      result.nsPerOp = seconds * 1e9 / n;
+      result.allocationsPerOp = double(allocations) / n;
+      result.opsPerSecond = seconds > 0 ? n / seconds : 0;
+      return result;
+    }
+  }
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Forms of nbCells cells grown by mitoses from the center of the
+ * grid, the same for every run
+ */
+/* -----------------------------------------------------------*/
+static std::vector<graphVertex> randomForms(
+    Environment &env,
+    std::size_t nbForms,
+    unsigned int nbCells)
+{
+  static const char directions[4] = {'u', 'd', 'r', 'l'};
+  std::vector<graphVertex> forms;
+  std::srand(1);
+  while (forms.size() < nbForms)
+  {
+    graphVertex form(width * height);
+    form.set((height / 2) * width + width / 2);
+    while (form.count() < nbCells)
+    {
+      std::vector<unsigned int> cells;
+      for (graphVertex::size_type pos = form.find_first();
+           pos != graphVertex::npos; pos = form.find_next(pos))
+        cells.push_back(pos);
+      env.mitose(form, cells[std::rand() % cells.size()],
+          directions[std::rand() % 4]);
+    }
+    forms.push_back(form);
+  }
+  return forms;
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Environment::mitose of a random cell in a random direction
+ */
+/* -----------------------------------------------------------*/
+struct MitoseOperation
+{
+  Environment &env;
+  const std::vector<graphVertex> &forms;
+  graphVertex form;
+
+  MitoseOperation(Environment &e, const std::vector<graphVertex> &f) :
+    env(e), forms(f) {}
+  void operator()(std::size_t i)
+  {
+    static const char directions[4] = {'u', 'd', 'r', 'l'};
+    form = forms[i % forms.size()];
+    env.mitose(form, form.find_first(), directions[i % 4]);
+  }
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief One of the geometrical transformations of Environment
+ */
+/* -----------------------------------------------------------*/
+struct TransformOperation
+{
+  Environment &env;
+  const std::vector<graphVertex> &forms;
+  unsigned int (Environment::*transform)(graphVertex &);
+  graphVertex form;
+
+  TransformOperation(Environment &e, const std::vector<graphVertex> &f,
+      unsigned int (Environment::*t)(graphVertex &)) :
+    env(e), forms(f), transform(t) {}
+  void operator()(std::size_t i)
+  {
+    form = forms[i % forms.size()];
+    (env.*transform)(form);
+  }
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief translationResult or existInGraph of a form which is not in the
+ * store, so that every lookup misses
+ */
+/* -----------------------------------------------------------*/
+struct LookupOperation
+{
+  Environment &env;
+  const TranslationIndex &index;
+  const graphVertex &absent;
+  bool allTransforms;
+
+  LookupOperation(Environment &e, const TranslationIndex &i,
+      const graphVertex &a, bool all) :
+    env(e), index(i), absent(a), allTransforms(all) {}
+  void operator()(std::size_t)
+  {
+    if (allTransforms)
+      env.existInGraph(index, absent);
+    else
+      env.translationResult(index, absent);
+  }
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief healthy_reaction or cancerous_reaction of a cell with the initial
+ * concentrations
+ */
+/* -----------------------------------------------------------*/
+struct ReactionOperation
+{
+  const GraphManager &gm;
+  bool healthy;
+  std::vector<double> parameters; /*!< initEne to initLac first*/
+  std::vector<double> energy, oxygen, glucose, lactate;
+
+  ReactionOperation(const GraphManager &g, bool h) :
+    gm(g), healthy(h), parameters(g.getParameters()),
+    energy(1), oxygen(1), glucose(1), lactate(1) {}
+  void operator()(std::size_t)
+  {
+    energy[0] = parameters[0];
+    oxygen[0] = parameters[1];
+    glucose[0] = parameters[2];
+    lactate[0] = parameters[3];
+    if (healthy)
+      gm.healthy_reaction(energy, oxygen, glucose, lactate, 0);
+    else
+      gm.cancerous_reaction(energy, oxygen, glucose, lactate, 0);
+  }
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief add_vertexToGForm, the graph being cleared every clearPeriod forms
+ * so that the memory stays bounded
+ */
+/* -----------------------------------------------------------*/
+struct AddVertexOperation
+{
+  static const std::size_t clearPeriod = 4096;
+  GraphManager &gm;
+  const std::vector<graphVertex> &forms;
+  std::vector<double> energy, oxygen, glucose, lactate;
+
+  AddVertexOperation(GraphManager &g, const std::vector<graphVertex> &f) :
+    gm(g), forms(f),
+    energy(width * height), oxygen(width * height),
+    glucose(width * height), lactate(width * height) {}
+  void operator()(std::size_t i)
+  {
+    if (i % clearPeriod == 0) gm.clearForms();
+    gm.add_vertexToGForm(forms[i % forms.size()],
+        energy, oxygen, glucose, lactate);
+  }
+};
+
+static void printCsv(const std::vector<BenchmarkResult> &results)
+{
+  std::cout << "benchmark,iterations,ns_per_op,allocations_per_op,ops_per_second"
+    << std::endl;
+  for (std::size_t r = 0; r < results.size(); r++)
+    std::cout << results[r].name << ","
+      << results[r].iterations << ","
+      << results[r].nsPerOp << ","
+      << results[r].allocationsPerOp << ","
+      << results[r].opsPerSecond << std::endl;
+}
+
+static void printJson(const std::vector<BenchmarkResult> &results)
+{
+  std::cout << "{\"benchmarks\": [" << std::endl;
+  for (std::size_t r = 0; r < results.size(); r++)
+    std::cout << "  {\"name\": \"" << results[r].name << "\""
+      << ", \"iterations\": " << results[r].iterations
+      << ", \"ns_per_op\": " << results[r].nsPerOp
+      << ", \"allocations_per_op\": " << results[r].allocationsPerOp
+      << ", \"ops_per_second\": " << results[r].opsPerSecond
+      << "}" << (r + 1 < results.size() ? "," : "") << std::endl;
+  std::cout << "]}" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+  std::string format = argc > 1 ? argv[1] : "csv";
+  double minSeconds = argc > 2 ? std::atof(argv[2]) : 0.2;
+  if (format != "csv" && format != "json")
+  {
+    std::cerr << "usage : " << argv[0] << " [csv|json] [seconds]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Environment env(maxCell, height, width);
+  std::vector<int> dim(3);
+  dim[0] = width;
+  dim[1] = height;
+  dim[2] = 1;
+  GraphManager gm(dim, Graph(),
+      0, 6, 18, 0,
+      1, 6, 36, 2, 2, 40,
+      1, 1, 4, 2, 90,
+      36);
+  std::vector<graphVertex> forms = randomForms(env, 1024, maxCell);
+  std::vector<BenchmarkResult> results;
+
+  MitoseOperation mitose(env, forms);
+  results.push_back(measure("mitose", mitose, minSeconds));
+
+  const char *transformNames[5] = {"rotation90Result", "rotation180Result",
+    "rotation270Result", "horSymResult", "vertSymResult"};
+  unsigned int (Environment::*transforms[5])(graphVertex &) = {
+    &Environment::rotation90Result, &Environment::rotation180Result,
+    &Environment::rotation270Result, &Environment::horSymResult,
+    &Environment::vertSymResult};
+  for (int t = 0; t < 5; t++)
+  {
+    TransformOperation transform(env, forms, transforms[t]);
+    results.push_back(measure(transformNames[t], transform, minSeconds));
+  }
+
+  // a line of maxCell cells is looked up in stores of random forms from
+  // which its translations, rotations and symmetries are removed, so that
+  // every lookup misses. The stores are indexed before the measure, as they
+  // are when their forms are stored
+  graphVertex absent(width * height);
+  for (unsigned int c = 0; c < maxCell; c++) absent.set(c);
+  graphVertex absentKey = env.canonicalForm(absent);
+  const std::size_t storeSizes[3] = {1000, 10000, 100000};
+  for (int s = 0; s < 3; s++)
+  {
+    Graph store;
+    std::vector<unsigned int> vertices;
+    std::vector<graphVertex> storeForms =
+      randomForms(env, storeSizes[s], maxCell);
+    for (std::size_t f = 0; f < storeForms.size(); f++)
+      if (env.canonicalForm(storeForms[f]) != absentKey)
+        vertices.push_back(boost::add_vertex(storeForms[f], store));
+    TranslationIndex index;
+    env.indexTranslations(store, vertices, index);
+
+    std::ostringstream suffix;
+    suffix << "/" << storeSizes[s];
+    LookupOperation translation(env, index, absent, false);
+    results.push_back(measure("translationResult" + suffix.str(),
+          translation, minSeconds));
+    LookupOperation exist(env, index, absent, true);
+    results.push_back(measure("existInGraph" + suffix.str(), exist,
+          minSeconds));
+  }
+
+  ReactionOperation healthy(gm, true);
+  results.push_back(measure("healthy_reaction", healthy, minSeconds));
+  ReactionOperation cancerous(gm, false);
+  results.push_back(measure("cancerous_reaction", cancerous, minSeconds));
+
+  AddVertexOperation addVertex(gm, forms);
+  results.push_back(measure("add_vertexToGForm", addVertex, minSeconds));
+
+  if (format == "json")
+    printJson(results);
+  else
+    printCsv(results);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file ScalingBenchmark.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * Run the whole enumeration for every configuration of a matrix and record
+ * each timestep : one CSV line, or one JSON object per line, per timestep.
+ *
+ *   Millenium-Cell-scaling [--width 10,20] [--height 10,20] [--maxCell 6,7]
+ *       [--healthy 0,1] [--firstPos center,0] [--threads 0] [--bounded]
+ *       [--format csv|json]
+ *
+ * The matrix is every combination of the values given. firstPos center is
+ * the middle cell of the grid, the cell 55 of main on a 10 x 10 grid.
+ */
+
+/* std include */
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* boost include */
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SCALING_FORK
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/* project include */
+#include "EnumerationEngine.hpp"
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Peak resident memory of the process in KiB, -1 if unknown
+ */
+/* -----------------------------------------------------------*/
+static long peakRss()
+{
+#ifdef SCALING_FORK
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage)) return -1;
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return -1;
+#endif
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Record each timestep of an enumeration and print it
+ */
+/* -----------------------------------------------------------*/
+class ScalingVisitor : public EnumerationVisitor
+{
+public:
+  ScalingVisitor(const EnumerationConfig &config, bool json) :
+    _config(config),
+    _json(json),
+    _nbEdges(0)
+  {
+  }
+
+  void startTimestep(unsigned int /*timestep*/)
+  {
+    _nbEdges = 0;
+    _start = boost::posix_time::microsec_clock::universal_time();
+  }
+
+  void examineEdge(
+      std::size_t /*source*/,
+      std::size_t /*target*/,
+      const graphEdge &/*edge*/)
+  {
+    _nbEdges++;
+  }
+
+  void finishTimestep(
+      unsigned int timestep,
+      std::size_t nbForms)
+  {
+    double seconds = (boost::posix_time::microsec_clock::universal_time() -
+        _start).total_microseconds() * 1e-6;
+    // every edge which does not reach a new form found an equivalent form
+    double duplicateRatio = _nbEdges ?
+      double(_nbEdges - nbForms) / _nbEdges : 0;
+
+    if (_json)
+    {
+      std::cout << "{\"width\": " << _config.width
+        << ", \"height\": " << _config.height
+        << ", \"maxCell\": " << _config.maxCell
+        << ", \"healthy\": " << (_config.healthy ? "true" : "false")
+        << ", \"firstPos\": " << _config.firstPos
+        << ", \"timestep\": " << timestep
+        << ", \"wall_seconds\": " << seconds
+        << ", \"peak_rss_kib\": " << peakRss()
+        << ", \"forms\": " << nbForms
+        << ", \"edges\": " << _nbEdges
+        << ", \"duplicate_ratio\": " << duplicateRatio << "}" << std::endl;
+    } else {
+      std::cout << _config.width << "," << _config.height << ","
+        << _config.maxCell << "," << _config.healthy << ","
+        << _config.firstPos << "," << timestep << "," << seconds << ","
+        << peakRss() << "," << nbForms << "," << _nbEdges << ","
+        << duplicateRatio << std::endl;
+    }
+  }
+
+private:
+  const EnumerationConfig &_config;
+  bool _json;
+  std::size_t _nbEdges;
+  boost::posix_time::ptime _start;
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Values of a comma separated list, "center" being given as -1
+ */
+/* -----------------------------------------------------------*/
+static std::vector<long> parseList(
+    const std::string &option,
+    const std::string &values)
+{
+  std::vector<long> list;
+  std::istringstream is(values);
+  std::string value;
+  while (std::getline(is, value, ','))
+  {
+    if (value == "center")
+    {
+      list.push_back(-1);
+      continue;
+    }
+    char *end;
+    long number = std::strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end || number < 0)
+      throw std::runtime_error("invalid value " + value + " for " + option);
+    list.push_back(number);
+  }
+  if (list.empty()) throw std::runtime_error("no value for " + option);
+  return list;
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Enumerate one configuration, in a child process when possible so
+ * that its peak memory is its own
+ *
+ * @return false if the enumeration failed
+ */
+/* -----------------------------------------------------------*/
+static bool runConfiguration(
+    const EnumerationConfig &config,
+    bool json)
+{
+#ifdef SCALING_FORK
+  std::cout.flush();
+  pid_t pid = fork();
+  if (pid < 0) throw std::runtime_error("cannot fork");
+  if (pid > 0)
+  {
+    int status;
+    if (waitpid(pid, &status, 0) < 0) return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+  }
+#endif
+
+  bool done = true;
+  try {
+    ScalingVisitor visitor(config, json);
+    EnumerationEngine engine(config);
+    engine.addVisitor(&visitor);
+    engine.run();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    done = false;
+  }
+
+#ifdef SCALING_FORK
+  std::cout.flush();
+  _exit(done ? EXIT_SUCCESS : EXIT_FAILURE);
+#endif
+  return done;
+}
+
+int main(int argc, char *argv[])
+{
+  std::vector<long> widths(1, 10), heights(1, 10), maxCells(1, 7);
+  std::vector<long> healthies(1, 0), firstPositions(1, -1);
+  unsigned int nbThreads = 0;
+  bool bounded = false;
+  bool json = false;
+
+  try {
+    for (int a = 1; a < argc; a++)
+    {
+      std::string option = argv[a];
+      if (option == "--bounded")
+      {
+        bounded = true;
+        continue;
+      }
+      if (a + 1 == argc) throw std::runtime_error("no value for " + option);
+      std::string value = argv[++a];
+      if (option == "--width") widths = parseList(option, value);
+      else if (option == "--height") heights = parseList(option, value);
+      else if (option == "--maxCell") maxCells = parseList(option, value);
+      else if (option == "--healthy") healthies = parseList(option, value);
+      else if (option == "--firstPos") firstPositions = parseList(option, value);
+      else if (option == "--threads") nbThreads = parseList(option, value)[0];
+      else if (option == "--format" && (value == "csv" || value == "json"))
+        json = value == "json";
+      else throw std::runtime_error("invalid option " + option + " " + value);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!json)
+    std::cout << "width,height,maxCell,healthy,firstPos,timestep,"
+      "wall_seconds,peak_rss_kib,forms,edges,duplicate_ratio" << std::endl;
+
+  int status = EXIT_SUCCESS;
+  for (std::size_t w = 0; w < widths.size(); w++)
+  for (std::size_t h = 0; h < heights.size(); h++)
+  for (std::size_t m = 0; m < maxCells.size(); m++)
+  for (std::size_t c = 0; c < healthies.size(); c++)
+  for (std::size_t f = 0; f < firstPositions.size(); f++)
+  {
+    EnumerationConfig config;
+    config.width = widths[w];
+    config.height = heights[h];
+    config.maxCell = maxCells[m];
+    config.healthy = healthies[c] != 0;
+    config.firstPos = firstPositions[f] < 0 ?
+      (config.height / 2) * config.width + config.width / 2 :
+      firstPositions[f];
+    config.nbThreads = nbThreads;
+    config.keepGraph = !bounded;
+    config.checkpointName = "";
+    if (config.firstPos >= config.width * config.height)
+    {
+      std::cerr << "firstPos " << config.firstPos << " out of a "
+        << config.width << " x " << config.height << " grid" << std::endl;
+      status = EXIT_FAILURE;
+      continue;
+    }
+
+    if (!runConfiguration(config, json)) status = EXIT_FAILURE;
+  }
+  return status;
+}
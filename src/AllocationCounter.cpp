@@ -0,0 +1,47 @@
+/**
+ * @file AllocationCounter.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "AllocationCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#include <boost/atomic.hpp>
+
+static boost::atomic<boost::uint64_t> nbAllocations(0);
+static boost::atomic<boost::uint64_t> bytesAllocated(0);
+
+// The counters are atomic, the allocations of the threads being counted too.
+// operator new[] and operator delete[] call these ones.
+void *operator new(std::size_t size)
+{
+  nbAllocations.fetch_add(1, boost::memory_order_relaxed);
+  bytesAllocated.fetch_add(size, boost::memory_order_relaxed);
+  void *p = std::malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) throw()
+{
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) throw()
+{
+  std::free(p);
+}
+
+boost::uint64_t AllocationCounter::getNbAllocations()
+{
+  return nbAllocations.load(boost::memory_order_relaxed);
+}
+
+boost::uint64_t AllocationCounter::getBytesAllocated()
+{
+  return bytesAllocated.load(boost::memory_order_relaxed);
+}
@@ -0,0 +1,42 @@
+/**
+ * @file AllocationCounter.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * Linking AllocationCounter.cpp replaces the global operator new and
+ * operator delete by versions counting every allocation of the program. It
+ * is linked in the micro-benchmarks, and in the other programs with the
+ * instrumentation only (cmake -DINSTRUMENTATION=ON).
+ */
+
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+/* boost include */
+#include <boost/cstdint.hpp>
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Allocations of the program since its start, from every thread
+ */
+/* -----------------------------------------------------------*/
+class AllocationCounter
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Number of operator new calls
+   */
+  /* -----------------------------------------------------------*/
+  static boost::uint64_t getNbAllocations();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Bytes asked to operator new
+   */
+  /* -----------------------------------------------------------*/
+  static boost::uint64_t getBytesAllocated();
+};
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file ConcentrationArena.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "ConcentrationArena.hpp"
+
+#include <cmath>
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Nearest step of a concentration, saturated to 16 bits
+ */
+/* -----------------------------------------------------------*/
+static boost::int16_t toFixed(double value, double scale)
+{
+  double steps = std::floor(value * scale + 0.5);
+  if (steps > 32767) return 32767;
+  if (steps < -32768) return -32768;
+  return static_cast<boost::int16_t>(steps);
+}
+
+ConcentrationArena::ConcentrationArena() :
+  _maxSize(0),
+  _precision(DOUBLE_PRECISION),
+  _fixedScale(128),
+  _size(0)
+{
+}
+
+ConcentrationArena::ConcentrationArena(
+    std::size_t maxSize,
+    ConcentrationPrecision precision,
+    double fixedScale) :
+  _maxSize(maxSize),
+  _precision(precision),
+  _fixedScale(fixedScale),
+  _size(0)
+{
+}
+
+void ConcentrationArena::reserve(std::size_t nbForms)
+{
+  for (unsigned int c = 0; c < NB_CONCENTRATIONS; c++)
+  {
+    switch (_precision)
+    {
+      case DOUBLE_PRECISION:
+        _doubles[c].reserve(nbForms * _maxSize);
+        break;
+      case FLOAT_PRECISION:
+        _floats[c].reserve(nbForms * _maxSize);
+        break;
+      case FIXED_POINT:
+        _fixed[c].reserve(nbForms * _maxSize);
+        break;
+    }
+  }
+}
+
+void ConcentrationArena::clear()
+{
+  for (unsigned int c = 0; c < NB_CONCENTRATIONS; c++)
+  {
+    _doubles[c].clear();
+    _floats[c].clear();
+    _fixed[c].clear();
+  }
+  _size = 0;
+}
+
+std::size_t ConcentrationArena::append(
+    const double *energy,
+    const double *oxygen,
+    const double *glucose,
+    const double *lactate)
+{
+  const double *values[NB_CONCENTRATIONS] = {energy, oxygen, glucose, lactate};
+  for (unsigned int c = 0; c < NB_CONCENTRATIONS; c++)
+  {
+    switch (_precision)
+    {
+      case DOUBLE_PRECISION:
+        _doubles[c].insert(_doubles[c].end(), values[c], values[c] + _maxSize);
+        break;
+      case FLOAT_PRECISION:
+        _floats[c].insert(_floats[c].end(), values[c], values[c] + _maxSize);
+        break;
+      case FIXED_POINT:
+        for (std::size_t i = 0; i < _maxSize; i++)
+          _fixed[c].push_back(toFixed(values[c][i], _fixedScale));
+        break;
+    }
+  }
+  return _size++;
+}
+
+void ConcentrationArena::get(
+    Concentration concentration,
+    std::size_t index,
+    std::vector<double> &values) const
+{
+  std::size_t first = index * _maxSize;
+  switch (_precision)
+  {
+    case DOUBLE_PRECISION:
+      values.assign(_doubles[concentration].begin() + first,
+          _doubles[concentration].begin() + first + _maxSize);
+      break;
+    case FLOAT_PRECISION:
+      values.assign(_floats[concentration].begin() + first,
+          _floats[concentration].begin() + first + _maxSize);
+      break;
+    case FIXED_POINT:
+      values.resize(_maxSize);
+      for (std::size_t i = 0; i < _maxSize; i++)
+        values[i] = _fixed[concentration][first + i] / _fixedScale;
+      break;
+  }
+}
+
+const double *ConcentrationArena::data(Concentration concentration) const
+{
+  if (_precision != DOUBLE_PRECISION || _doubles[concentration].empty())
+    return NULL;
+  return &_doubles[concentration][0];
+}
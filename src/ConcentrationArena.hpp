@@ -0,0 +1,172 @@
+/**
+ * @file ConcentrationArena.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef CONCENTRATIONARENA_HPP
+#define CONCENTRATIONARENA_HPP
+
+/* std include */
+#include <cstddef>
+#include <vector>
+
+/* boost include */
+#include <boost/cstdint.hpp>
+#include <boost/serialization/vector.hpp>
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Concentrations saved with each form
+ */
+/* -----------------------------------------------------------*/
+enum Concentration
+{
+  ENERGY,
+  OXYGEN,
+  GLUCOSE,
+  LACTATE,
+  NB_CONCENTRATIONS
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Storage of the concentrations in a ConcentrationArena
+ */
+/* -----------------------------------------------------------*/
+enum ConcentrationPrecision
+{
+  DOUBLE_PRECISION, /*!< exact, 8 bytes per cell*/
+  FLOAT_PRECISION, /*!< 4 bytes per cell*/
+  FIXED_POINT /*!< 2 bytes per cell, multiples of 1 / fixedScale*/
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Concentrations of the env of every form, in one array per species
+ * The env of form i is the row i of maxSize values of each array, so that
+ * adding a form never allocates once the arrays are reserved and a scan over
+ * the forms reads contiguous memory.
+ */
+/* -----------------------------------------------------------*/
+class ConcentrationArena
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Default constructor, arena of 0 cell per form
+   */
+  /* -----------------------------------------------------------*/
+  ConcentrationArena();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Constructor
+   *
+   * @param maxSize : number of cells of the env of a form
+   * @param precision : storage of the concentrations
+   * @param fixedScale : steps per unit of concentration for FIXED_POINT, the
+   * values are rounded to the nearest step and saturate at 32767 steps
+   */
+  /* -----------------------------------------------------------*/
+  explicit ConcentrationArena(
+      std::size_t maxSize,
+      ConcentrationPrecision precision = DOUBLE_PRECISION,
+      double fixedScale = 128);
+
+  std::size_t getMaxSize() const { return _maxSize; }
+  ConcentrationPrecision getPrecision() const { return _precision; }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Number of forms in the arena
+   */
+  /* -----------------------------------------------------------*/
+  std::size_t size() const { return _size; }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Reserve room for nbForms forms, to fill a layer without
+   * reallocating
+   */
+  /* -----------------------------------------------------------*/
+  void reserve(std::size_t nbForms);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Remove every form, the memory reserved being kept
+   */
+  /* -----------------------------------------------------------*/
+  void clear();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Add the env of a form
+   *
+   * @param[in] energy : energy concentration, maxSize values
+   * @param[in] oxygen : oxygen concentration, maxSize values
+   * @param[in] glucose : glucose concentration, maxSize values
+   * @param[in] lactate : lactate concentration, maxSize values
+   *
+   * @return the index of the form in the arena
+   */
+  /* -----------------------------------------------------------*/
+  std::size_t append(
+      const double *energy,
+      const double *oxygen,
+      const double *glucose,
+      const double *lactate);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Get a concentration of a form
+   *
+   * @param[in] concentration : species
+   * @param[in] index : index of the form
+   * @param[out] values : maxSize values, as doubles whatever the precision
+   */
+  /* -----------------------------------------------------------*/
+  void get(
+      Concentration concentration,
+      std::size_t index,
+      std::vector<double> &values) const;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Direct access to the doubles of a species
+   *
+   * @return the size() x maxSize values of the species in DOUBLE_PRECISION,
+   * NULL otherwise
+   */
+  /* -----------------------------------------------------------*/
+  const double *data(Concentration concentration) const;
+
+  template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+      ar & _maxSize;
+      ar & _precision;
+      ar & _fixedScale;
+      ar & _size;
+      for (unsigned int c = 0; c < NB_CONCENTRATIONS; c++)
+      {
+        ar & _doubles[c];
+        ar & _floats[c];
+        ar & _fixed[c];
+      }
+    }
+
+private:
+  std::size_t _maxSize; /*!< cells of the env of a form*/
+  ConcentrationPrecision _precision;
+  double _fixedScale; /*!< steps per unit in FIXED_POINT*/
+  std::size_t _size; /*!< number of forms*/
+
+  /* arrays of each species, only the one of the precision is used */
+  std::vector<double> _doubles[NB_CONCENTRATIONS];
+  std::vector<float> _floats[NB_CONCENTRATIONS];
+  std::vector<boost::int16_t> _fixed[NB_CONCENTRATIONS];
+};
+
+#endif
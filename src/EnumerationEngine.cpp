@@ -0,0 +1,426 @@
+/**
+ * @file EnumerationEngine.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "EnumerationEngine.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/thread/thread.hpp>
+
+#include "FormTransform.hpp"
+#include "ResultStore.hpp"
+#include "Trace.hpp"
+
+EnumerationConfig::EnumerationConfig() :
+  width(10),
+  height(10),
+  firstPos(55),
+  maxCell(7),
+  healthy(false),
+  initEne(0),
+  initOxy(6),
+  initGlu(18),
+  initLac(0),
+  hInGlu(1),
+  hInOxy(6),
+  hOutEneOxy(36),
+  hOutEneNoOxy(2),
+  hOutLac(2),
+  hLacMitose(40),
+  cInGlu(1),
+  cInOxy(1),
+  cOutEne(4),
+  cOutLac(2),
+  cLacMitose(90),
+  eneMitose(36),
+  precision(DOUBLE_PRECISION),
+  lazyEnv(false),
+  envCacheSize(64),
+  nbThreads(0),
+  batchSize(4096),
+  memoryBudget(0),
+  spillDirectory("."),
+  keepGraph(true),
+  checkpointName("checkpoint.bin")
+{
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Dimension of the env as given to GraphManager
+ */
+/* -----------------------------------------------------------*/
+static std::vector<int> gridDim(const EnumerationConfig &config)
+{
+  std::vector<int> dim(3);
+  dim[0] = config.width;
+  dim[1] = config.height;
+  dim[2] = 1;
+  return dim;
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Counter of a duplicate hit by the Symmetry taking the child onto
+ * the form already reached, up to a translation
+ *
+ * @param reached : Symmetry of the form already reached which is the key
+ * @param child : Symmetry of the child which is the key
+ */
+/* -----------------------------------------------------------*/
+static Instrumentation::Counter duplicateCounter(
+    unsigned int reached,
+    unsigned int child)
+{
+  Symmetry childToReached =
+    composeSymmetries(inverseSymmetry(Symmetry(reached)), Symmetry(child));
+  return Instrumentation::Counter(
+      Instrumentation::DUPLICATE_HITS_IDENTITY + childToReached);
+}
+
+EnumerationEngine::EnumerationEngine(const EnumerationConfig &config) :
+  _config(config),
+  _env(config.maxCell, config.height, config.width),
+  _gm(gridDim(config), Graph(),
+      config.initEne, config.initOxy, config.initGlu, config.initLac,
+      config.hInGlu, config.hInOxy, config.hOutEneOxy, config.hOutEneNoOxy,
+      config.hOutLac, config.hLacMitose,
+      config.cInGlu, config.cInOxy, config.cOutEne, config.cOutLac,
+      config.cLacMitose,
+      config.eneMitose, config.precision),
+  _expander(_env, _gm, config.healthy,
+      config.nbThreads ? config.nbThreads :
+      boost::thread::hardware_concurrency()),
+  _frontier(config.spillDirectory, config.memoryBudget),
+  _firstFormId(0)
+{
+  if (!_config.keepGraph && _config.lazyEnv)
+    throw std::runtime_error("A lazy env needs the whole graph");
+  if (_config.batchSize == 0) _config.batchSize = 1;
+
+  // the env of the forms is recomputed from their parent when it is read,
+  // the last envCacheSize env read being kept
+  if (_config.lazyEnv) _gm.setLazyEnv(_config.healthy, _config.envCacheSize);
+}
+
+void EnumerationEngine::addVisitor(EnumerationVisitor *visitor)
+{
+  _visitors.push_back(visitor);
+}
+
+void EnumerationEngine::resume(const std::string &fileName)
+{
+  {
+    ResultStore previous(fileName);
+    loadResultStore(previous, _gm, _verticesPerTimestep,
+        _config.height, _config.width, _config.healthy);
+  }
+  _resumedFrom = fileName;
+  if (!_config.keepGraph) dropPreviousTimesteps();
+}
+
+void EnumerationEngine::run()
+{
+  if (_verticesPerTimestep.empty()) addRoot();
+  if (!_config.checkpointName.empty()) openCheckpoint();
+
+  // Loop until getting all recheable forms with the right number of cells
+  while (getTimestep() + 1 < _config.maxCell) expandTimestep();
+
+  // wait for the last timestep to be written
+  if (_checkpoint) {
+    _checkpoint->close();
+    _checkpoint.reset();
+  }
+}
+
+const std::vector<unsigned int>& EnumerationEngine::getVerticesPerTimestep() const
+{
+  return _verticesPerTimestep;
+}
+
+unsigned int EnumerationEngine::getTimestep() const
+{
+  return _verticesPerTimestep.size() - 1;
+}
+
+void EnumerationEngine::addRoot()
+{
+  std::size_t maxSize = _config.width * _config.height;
+  graphVertex root(maxSize, 0); // The starting form
+  root.set(_config.firstPos);
+
+  LayerExpansion rootEnv;
+  rootEnv.energy.assign(maxSize, _config.initEne);
+  rootEnv.oxygen.assign(maxSize, _config.initOxy);
+  rootEnv.glucose.assign(maxSize, _config.initGlu);
+  rootEnv.lactate.assign(maxSize, _config.initLac);
+
+  for (std::size_t i = 0; i < _visitors.size(); i++)
+    _visitors[i]->startTimestep(0);
+  Vertex vertex = discoverForm(root, rootEnv, NO_PARENT);
+  unsigned int symmetry;
+  graphVertex key = _env.canonicalForm(root, symmetry);
+  _gm.indexForm(key, vertex, symmetry);
+
+  // At initial time 0 we have just one node corresponding to the root
+  _verticesPerTimestep.push_back(1);
+  for (std::size_t i = 0; i < _visitors.size(); i++)
+    _visitors[i]->finishTimestep(0, 1);
+}
+
+void EnumerationEngine::expandTimestep()
+{
+  unsigned int timestep = _verticesPerTimestep.size();
+  // Count the number of vertices added in the timestep
+  unsigned int countVerticesPerTime = 0;
+  InstrumentationCounters counters;
+  TraceScope timestepScope(TRACE_TIMESTEP, timestep);
+
+  for (std::size_t i = 0; i < _visitors.size(); i++)
+    _visitors[i]->startTimestep(timestep);
+
+  // The nodes of previous timestep, from the last one
+  _parents.clear();
+  Vertex end = boost::num_vertices(_gm.getGForm());
+  for (unsigned int nbVertices = 0;
+       nbVertices < _verticesPerTimestep.back(); nbVertices++)
+    _parents.push_back(--end);
+
+  // Expand the forms of the timestep on every core, by batches of parents so
+  // that the memory used by the expansions stays bounded
+  for (std::size_t first = 0; first < _parents.size();
+       first += _config.batchSize) {
+    std::size_t last = std::min(first + _config.batchSize, _parents.size());
+    {
+      TraceScope expandScope(TRACE_EXPAND_BATCH, first);
+      _expander.expand(_parents, first, last, _expansions);
+    }
+
+    // Add the reached forms to the graph in the order of the parents, the
+    // graph does not depend on the number of threads
+    TraceScope insertScope(TRACE_INSERT_BATCH, first);
+    for (std::size_t i = first; i < last; i++) {
+      const LayerExpansion &expansion = _expansions[i - first];
+
+      for (std::size_t c = 0; c < expansion.children.size(); c++) {
+        const LayerChild &child = expansion.children[c];
+
+        // Calculating the subset of reachable sets or enforcing the some
+        // crossing constraints
+        // At the time of crossing constraints, compare in an automated way
+        // (rather than by the user) the reached forms to the forms of the
+        // catalog defined at the beginning
+        // then continuing with the corresponding ones
+
+        // First crossing constraints
+        //                      if(timestep == bridgeTime4)
+        //                      {
+        //                          unsigned int inCatalog =
+        //                          env->existInGraph(catalogIndex4,child.form);
+        //                          if(!inCatalog)
+        //                          continue;
+        //                      }
+        //
+
+        // Second crossing constraints
+        //                      if(timestep == bridgeTime8)
+        //                      {
+        //                          unsigned int inCatalog =
+        //                          env->existInGraph(catalogIndex8,child.form);
+        //                          if(!inCatalog)
+        //                          continue;
+        //                      }
+
+        // Out of core, the children are deduplicated once the whole
+        // timestep is expanded
+        if (_config.memoryBudget) {
+          InstrumentationTimer dedupTimer;
+          _frontier.add(child.key, i, child.control, child.mitoser,
+              child.symmetry);
+          counters.add(Instrumentation::DEDUP_NS, dedupTimer.elapsed());
+          continue;
+        }
+
+        // Define an edge that link the two vertices and add properties
+        graphEdge edge;
+        edge.Control = child.control;
+        edge.Mitoser = child.mitoser;
+        edge.Temps = timestep;
+
+        // Test if there is any redundance, also with geometrical
+        // transformation : equivalent forms share the same canonical
+        // key, so a single lookup in the form index is enough
+        Vertex vertex;
+        unsigned int symmetry;
+        InstrumentationTimer dedupTimer;
+        bool found = _gm.findForm(child.key, vertex, symmetry);
+        counters.add(Instrumentation::DEDUP_NS, dedupTimer.elapsed());
+
+        // If there is no redundance
+        InstrumentationTimer insertionTimer;
+        if (!found) {
+          // Add the newly created form in the form graph and save the env
+          vertex = discoverForm(child.form, expansion, _parents[i]);
+          _gm.indexForm(child.key, vertex, child.symmetry);
+
+          // Increment the number of added vertices in the current
+          // timestep
+          countVerticesPerTime++;
+        } else {
+          counters.add(Instrumentation::DUPLICATE_HITS);
+          counters.add(duplicateCounter(symmetry, child.symmetry));
+        }
+
+        // link the two vertices, if the newly created form already exist
+        // in the graph just a new edge is created
+        examineEdge(_parents[i], vertex, edge);
+        counters.add(Instrumentation::INSERTION_NS, insertionTimer.elapsed());
+      }
+    }
+  }
+
+  // The children come back sorted by key, the first child of a key is the
+  // first one reached and the new forms are added in the order of the keys
+  if (_config.memoryBudget) {
+    FrontierRecord record;
+    bool newForm;
+    Vertex vertex = 0;
+    unsigned int symmetry = IDENTITY; /* of the first child of the key*/
+
+    InstrumentationTimer mergeTimer;
+    {
+      TraceScope mergeScope(TRACE_FRONTIER_MERGE, timestep);
+      _frontier.merge();
+    }
+    counters.add(Instrumentation::DEDUP_NS, mergeTimer.elapsed());
+    while (_frontier.next(record, newForm)) {
+      InstrumentationTimer insertionTimer;
+      if (newForm) {
+        // Rebuild the child from its parent, whose env is recomputed
+        // unless the graph does not save it
+        graphVertex mitoForm = _gm.getForm(_parents[record.parent]);
+        if (!_gm.hasLazyEnv()) _expander.react(mitoForm, _parentEnv);
+        mitoForm.set(_env.daughterPosition(record.mitoser, record.control));
+
+        vertex = discoverForm(mitoForm, _parentEnv, _parents[record.parent]);
+        symmetry = record.symmetry;
+        countVerticesPerTime++;
+      } else {
+        counters.add(Instrumentation::DUPLICATE_HITS);
+        counters.add(duplicateCounter(symmetry, record.symmetry));
+      }
+
+      graphEdge edge;
+      edge.Control = record.control;
+      edge.Mitoser = record.mitoser;
+      edge.Temps = timestep;
+      examineEdge(_parents[record.parent], vertex, edge);
+      counters.add(Instrumentation::INSERTION_NS, insertionTimer.elapsed());
+    }
+    _frontier.clear();
+  }
+
+  // record the total number of nodes added at the current timestep
+  _verticesPerTimestep.push_back(countVerticesPerTime);
+
+  // the timestep is written while the next one is expanded
+  if (_checkpoint) storeTimestep();
+
+  // the counters of the timestep are in the totals before the visitors
+  // are told it is done
+  counters.flush();
+  for (std::size_t i = 0; i < _visitors.size(); i++)
+    _visitors[i]->finishTimestep(timestep, countVerticesPerTime);
+
+  if (!_config.keepGraph) dropPreviousTimesteps();
+}
+
+Vertex EnumerationEngine::discoverForm(
+    const graphVertex &form,
+    const LayerExpansion &parentEnv,
+    Vertex parent)
+{
+  Vertex vertex = _gm.add_vertexToGForm(form,
+      parentEnv.energy, parentEnv.oxygen,
+      parentEnv.glucose, parentEnv.lactate, parent);
+  for (std::size_t i = 0; i < _visitors.size(); i++)
+    _visitors[i]->discoverForm(_firstFormId + vertex,
+        _verticesPerTimestep.size(), form);
+  return vertex;
+}
+
+void EnumerationEngine::examineEdge(
+    Vertex source,
+    Vertex target,
+    const graphEdge &edge)
+{
+  _gm.add_edgeToGForm(source, target, edge);
+  for (std::size_t i = 0; i < _visitors.size(); i++)
+    _visitors[i]->examineEdge(_firstFormId + source, _firstFormId + target,
+        edge);
+}
+
+void EnumerationEngine::dropPreviousTimesteps()
+{
+  std::size_t nbForms = _verticesPerTimestep.back();
+  std::size_t first = boost::num_vertices(_gm.getGForm()) - nbForms;
+  if (first == 0) return;
+
+  // the forms of the last timestep are added again as roots, their children
+  // only being looked up among the forms of the next timestep
+  std::vector<graphVertex> forms(nbForms);
+  std::vector<FormEnv> envs(nbForms);
+  for (std::size_t k = 0; k < nbForms; k++)
+    _gm.getFormFromGraph(first + k, forms[k], envs[k].energy,
+        envs[k].oxygen, envs[k].glucose, envs[k].lactate);
+
+  _gm.clearForms();
+  for (std::size_t k = 0; k < nbForms; k++)
+    _gm.add_vertexToGForm(forms[k], envs[k].energy, envs[k].oxygen,
+        envs[k].glucose, envs[k].lactate);
+  _firstFormId += first;
+}
+
+void EnumerationEngine::openCheckpoint()
+{
+  // a resumed checkpoint already holds the timesteps done
+  if (_config.checkpointName == _resumedFrom) {
+    _checkpoint.reset(new ResultStoreWriter(_config.checkpointName));
+    if (_checkpoint->getNbTimesteps() != _verticesPerTimestep.size())
+      throw std::runtime_error("The checkpoint changed since it was resumed");
+    return;
+  }
+
+  if (_firstFormId)
+    throw std::runtime_error("A new checkpoint needs the whole graph");
+  _checkpoint.reset(new ResultStoreWriter(_config.checkpointName,
+      _gm.getParameters(), _config.height, _config.width, _config.healthy));
+  std::size_t sourceFirst = 0, first = 0;
+  for (std::size_t t = 0; t < _verticesPerTimestep.size(); t++) {
+    std::size_t last = first + _verticesPerTimestep[t];
+    getStoredTimestep(_gm, sourceFirst, first, last, 0, _storedTimestep);
+    _checkpoint->add(_storedTimestep);
+    sourceFirst = first;
+    first = last;
+  }
+}
+
+void EnumerationEngine::storeTimestep()
+{
+  // the last timestep and the one before are at the end of the graph, with
+  // keepGraph false too
+  std::size_t last = boost::num_vertices(_gm.getGForm());
+  std::size_t first = last - _verticesPerTimestep.back();
+  std::size_t sourceFirst = first -
+    _verticesPerTimestep[_verticesPerTimestep.size() - 2];
+  getStoredTimestep(_gm, sourceFirst, first, last, _firstFormId,
+      _storedTimestep);
+  _checkpoint->add(_storedTimestep);
+}
@@ -0,0 +1,288 @@
+/**
+ * @file EnumerationEngine.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef ENUMERATIONENGINE_HPP
+#define ENUMERATIONENGINE_HPP
+
+/* std include */
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* boost include */
+#include <boost/scoped_ptr.hpp>
+
+/* project include */
+#include "environment.h"
+#include "ExternalFrontier.hpp"
+#include "GraphManager.hpp"
+#include "LayerExpander.hpp"
+#include "ResultStore.hpp"
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Parameters of an enumeration, the default values being the ones of
+ * the simulation of main
+ */
+/* -----------------------------------------------------------*/
+struct EnumerationConfig
+{
+  EnumerationConfig();
+
+  /* grid and starting form */
+  unsigned int width;
+  unsigned int height;
+  unsigned int firstPos; /*!< position of the cell of the root form*/
+  unsigned int maxCell; /*!< number of cells of the last forms*/
+
+  /* cells, see GraphManager::GraphManager for the thresholds */
+  bool healthy; /*!< true if healthy, false if cancerous*/
+  double initEne;
+  double initOxy;
+  double initGlu;
+  double initLac;
+  double hInGlu;
+  double hInOxy;
+  double hOutEneOxy;
+  double hOutEneNoOxy;
+  double hOutLac;
+  double hLacMitose;
+  double cInGlu;
+  double cInOxy;
+  double cOutEne;
+  double cOutLac;
+  double cLacMitose;
+  double eneMitose;
+
+  /* storage of the env, see GraphManager::setLazyEnv */
+  ConcentrationPrecision precision;
+  bool lazyEnv;
+  std::size_t envCacheSize;
+
+  /* expansion of a timestep */
+  unsigned int nbThreads; /*!< 0 for the number of cores*/
+  std::size_t batchSize; /*!< parents expanded at once*/
+  std::size_t memoryBudget; /*!< see ExternalFrontier, 0 dedupes in memory*/
+  std::string spillDirectory;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * false keeps only the last timestep in the GraphManager, the memory then
+   * being bounded by one timestep. The forms and edges are only seen by the
+   * visitors and the checkpoint, there is no lazy env.
+   */
+  /* -----------------------------------------------------------*/
+  bool keepGraph;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * Result store to which each timestep is added by a background thread
+   * while the next one is expanded, empty for none. The run can be resumed
+   * from it if it stops.
+   */
+  /* -----------------------------------------------------------*/
+  std::string checkpointName;
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Receiver of the events of an enumeration
+ * The default implementation ignores every event. During a call the form
+ * with the id i is the vertex i - getFirstFormId() of the GraphManager of
+ * the engine.
+ */
+/* -----------------------------------------------------------*/
+class EnumerationVisitor
+{
+public:
+  virtual ~EnumerationVisitor() {}
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief A timestep is going to be expanded
+   *
+   * @param timestep : timestep of the new forms, the root being timestep 0
+   */
+  /* -----------------------------------------------------------*/
+  virtual void startTimestep(unsigned int /*timestep*/) {}
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief A new form is reached
+   *
+   * @param id : id of the form, the number of forms reached before it
+   * @param timestep : timestep of the form
+   * @param form : cells of the form
+   */
+  /* -----------------------------------------------------------*/
+  virtual void discoverForm(
+      std::size_t /*id*/,
+      unsigned int /*timestep*/,
+      const graphVertex &/*form*/) {}
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief A mitosis of the form source reaches the form target, which is
+   * discovered before its first edge
+   */
+  /* -----------------------------------------------------------*/
+  virtual void examineEdge(
+      std::size_t /*source*/,
+      std::size_t /*target*/,
+      const graphEdge &/*edge*/) {}
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Every form and edge of a timestep has been given
+   *
+   * @param timestep : timestep done
+   * @param nbForms : number of forms of the timestep
+   */
+  /* -----------------------------------------------------------*/
+  virtual void finishTimestep(
+      unsigned int /*timestep*/,
+      std::size_t /*nbForms*/) {}
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Enumeration of the forms reachable from a one cell form, timestep
+ * by timestep, each timestep adding a cell
+ * The forms and edges are given to the visitors as they are found, the
+ * GraphManager keeps the whole graph or only the last timestep.
+ */
+/* -----------------------------------------------------------*/
+class EnumerationEngine
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Constructor
+   *
+   * @param config : parameters of the enumeration, copied
+   * Throws std::runtime_error if keepGraph is false with a lazy env.
+   */
+  /* -----------------------------------------------------------*/
+  explicit EnumerationEngine(const EnumerationConfig &config);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Add a visitor, which is not owned and must outlive run
+   */
+  /* -----------------------------------------------------------*/
+  void addVisitor(EnumerationVisitor *visitor);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Continue the enumeration saved in a result store instead of
+   * starting from the root, to be called before run
+   * The visitors only see the timesteps computed by run. If it is the
+   * checkpoint, the new timesteps are added to it. Throws std::runtime_error
+   * if the store does not match the config.
+   */
+  /* -----------------------------------------------------------*/
+  void resume(const std::string &fileName);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Expand the timesteps until the forms have maxCell cells
+   * Returns once the checkpoint is written. Throws std::runtime_error if it
+   * cannot be.
+   */
+  /* -----------------------------------------------------------*/
+  void run();
+
+  const EnumerationConfig& getConfig() const { return _config; }
+  Environment& getEnvironment() { return _env; }
+  const GraphManager& getGraphManager() const { return _gm; }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Number of forms of each timestep, from the root
+   */
+  /* -----------------------------------------------------------*/
+  const std::vector<unsigned int>& getVerticesPerTimestep() const;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Last timestep expanded
+   */
+  /* -----------------------------------------------------------*/
+  unsigned int getTimestep() const;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Id of the vertex 0 of the GraphManager, 0 with keepGraph
+   */
+  /* -----------------------------------------------------------*/
+  std::size_t getFirstFormId() const { return _firstFormId; }
+
+private:
+  void addRoot();
+  void expandTimestep();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Add a new form to the graph and give it to the visitors
+   */
+  /* -----------------------------------------------------------*/
+  Vertex discoverForm(
+      const graphVertex &form,
+      const LayerExpansion &parentEnv,
+      Vertex parent);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Add an edge to the graph and give it to the visitors
+   */
+  /* -----------------------------------------------------------*/
+  void examineEdge(
+      Vertex source,
+      Vertex target,
+      const graphEdge &edge);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Keep only the forms of the last timestep in the graph
+   */
+  /* -----------------------------------------------------------*/
+  void dropPreviousTimesteps();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Start writing the checkpoint with the timesteps already done
+   */
+  /* -----------------------------------------------------------*/
+  void openCheckpoint();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Give the last timestep to the checkpoint writer
+   */
+  /* -----------------------------------------------------------*/
+  void storeTimestep();
+
+  EnumerationConfig _config;
+  Environment _env;
+  GraphManager _gm;
+  LayerExpander _expander;
+  ExternalFrontier _frontier;
+  std::vector<EnumerationVisitor*> _visitors;
+
+  std::vector<unsigned int> _verticesPerTimestep;
+  std::size_t _firstFormId; /*!< id of the vertex 0 of _gm*/
+  std::string _resumedFrom; /*!< store given to resume*/
+  boost::scoped_ptr<ResultStoreWriter> _checkpoint;
+  StoredTimestep _storedTimestep; /*!< buffers of the timestep stored*/
+
+  /* buffers of a timestep */
+  std::vector<Vertex> _parents; /*!< forms of the previous timestep*/
+  std::vector<LayerExpansion> _expansions;
+  LayerExpansion _parentEnv;
+};
+
+#endif
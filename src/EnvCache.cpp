@@ -0,0 +1,55 @@
+/**
+ * @file EnvCache.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "EnvCache.hpp"
+
+EnvCache::EnvCache(std::size_t capacity) :
+  _capacity(capacity)
+{
+}
+
+void EnvCache::setCapacity(std::size_t capacity)
+{
+  _capacity = capacity;
+  while (_entries.size() > _capacity)
+  {
+    _index.erase(_entries.back().first);
+    _entries.pop_back();
+  }
+}
+
+const FormEnv *EnvCache::find(std::size_t index)
+{
+  boost::unordered_map<std::size_t, EntryList::iterator>::iterator it =
+    _index.find(index);
+  if (it == _index.end()) return NULL;
+  _entries.splice(_entries.begin(), _entries, it->second);
+  return &it->second->second;
+}
+
+void EnvCache::insert(
+    std::size_t index,
+    const FormEnv &env)
+{
+  if (_entries.size() == _capacity)
+  {
+    // the buffers of the dropped env are reused
+    _index.erase(_entries.back().first);
+    _entries.splice(_entries.begin(), _entries, --_entries.end());
+    _entries.front().first = index;
+    _entries.front().second = env;
+  } else {
+    _entries.push_front(std::make_pair(index, env));
+  }
+  _index[index] = _entries.begin();
+}
+
+void EnvCache::clear()
+{
+  _entries.clear();
+  _index.clear();
+}
@@ -0,0 +1,82 @@
+/**
+ * @file EnvCache.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef ENVCACHE_HPP
+#define ENVCACHE_HPP
+
+/* std include */
+#include <cstddef>
+#include <list>
+#include <utility>
+#include <vector>
+
+/* boost include */
+#include <boost/unordered_map.hpp>
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Concentrations of the env of a form
+ */
+/* -----------------------------------------------------------*/
+struct FormEnv
+{
+  std::vector<double> energy;
+  std::vector<double> oxygen;
+  std::vector<double> glucose;
+  std::vector<double> lactate;
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief The env of the last forms used, the least recently used one being
+ * dropped when the cache is full
+ */
+/* -----------------------------------------------------------*/
+class EnvCache
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Constructor
+   *
+   * @param capacity : number of env kept, 0 keeps none
+   */
+  /* -----------------------------------------------------------*/
+  explicit EnvCache(std::size_t capacity = 0);
+
+  std::size_t getCapacity() const { return _capacity; }
+  void setCapacity(std::size_t capacity);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Look up the env of a form, which becomes the most recently used
+   *
+   * @return the env, NULL if it is not in the cache
+   */
+  /* -----------------------------------------------------------*/
+  const FormEnv *find(std::size_t index);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Keep the env of a form, the capacity must not be 0
+   */
+  /* -----------------------------------------------------------*/
+  void insert(
+      std::size_t index,
+      const FormEnv &env);
+
+  void clear();
+
+private:
+  typedef std::list< std::pair<std::size_t, FormEnv> > EntryList;
+
+  std::size_t _capacity;
+  EntryList _entries; /*!< most recently used first*/
+  boost::unordered_map<std::size_t, EntryList::iterator> _index;
+};
+
+#endif
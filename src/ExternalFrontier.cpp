@@ -0,0 +1,227 @@
+/**
+ * @file ExternalFrontier.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "ExternalFrontier.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include <boost/atomic.hpp>
+
+/* frontiers created by the process, to name their runs apart */
+static boost::atomic<unsigned int> nbFrontiers(0);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Order of the runs by their next child
+ */
+/* -----------------------------------------------------------*/
+class HeadLess
+{
+public:
+  explicit HeadLess(const std::vector<FrontierRecord> &heads) : _heads(heads) {}
+  bool operator()(unsigned int a, unsigned int b) const
+  {
+    return _heads[a] < _heads[b];
+  }
+
+private:
+  const std::vector<FrontierRecord> &_heads;
+};
+
+ExternalFrontier::ExternalFrontier(
+    const std::string &directory,
+    std::size_t memoryBudget) :
+  _directory(directory),
+  _memoryBudget(memoryBudget),
+  _bufferBytes(0),
+  _bufferPos(0),
+  _nbRecords(0),
+  _hasLast(false)
+{
+  // the runs of every frontier of every process sharing the directory are
+  // named apart
+  std::ostringstream prefix;
+  prefix << _directory << "/frontier" << getpid() << "-"
+    << nbFrontiers++ << "-";
+  _runPrefix = prefix.str();
+}
+
+ExternalFrontier::~ExternalFrontier()
+{
+  clear();
+}
+
+void ExternalFrontier::add(
+    const Form &key,
+    std::size_t parent,
+    char control,
+    unsigned int mitoser,
+    unsigned int symmetry)
+{
+  _buffer.push_back(FrontierRecord());
+  FrontierRecord &record = _buffer.back();
+  record.key = key;
+  record.seq = _nbRecords++;
+  record.parent = parent;
+  record.mitoser = mitoser;
+  record.control = control;
+  record.symmetry = symmetry;
+
+  // keys of big grids do not fit in the form itself
+  _bufferBytes += sizeof(FrontierRecord);
+  if (key.size() > Form::INLINE_BITS)
+    _bufferBytes += key.num_blocks() * sizeof(Form::block_type);
+
+  if (_memoryBudget && _bufferBytes >= _memoryBudget) spill();
+}
+
+void ExternalFrontier::spill()
+{
+  std::sort(_buffer.begin(), _buffer.end());
+
+  std::ostringstream name;
+  name << _runPrefix << _runs.size() << ".run";
+  std::ofstream run(name.str().c_str(), std::ios::out | std::ios::binary);
+  if (!run)
+    throw std::runtime_error("cannot create the run file " + name.str());
+  _runs.push_back(name.str());
+
+  for (std::size_t i = 0; i < _buffer.size(); i++)
+    writeRecord(run, _buffer[i]);
+  if (!run)
+    throw std::runtime_error("cannot write the run file " + name.str());
+
+  _buffer.clear();
+  _bufferBytes = 0;
+}
+
+void ExternalFrontier::merge()
+{
+  _hasLast = false;
+  if (_runs.empty())
+  {
+    // everything fits in the budget, sort in memory
+    std::sort(_buffer.begin(), _buffer.end());
+    _bufferPos = 0;
+    return;
+  }
+
+  if (!_buffer.empty()) spill();
+  std::vector<FrontierRecord>().swap(_buffer);
+
+  _heads.resize(_runs.size());
+  for (unsigned int r = 0; r < _runs.size(); r++)
+  {
+    _readers.push_back(new std::ifstream(_runs[r].c_str(),
+          std::ios::in | std::ios::binary));
+    if (!_readers.back())
+      throw std::runtime_error("cannot open the run file " + _runs[r]);
+    // runs are never empty
+    readRecord(_readers.back(), _heads[r]);
+    _heap.push_back(r);
+  }
+  // runs sorted by head are a heap with the smallest head on top
+  std::sort(_heap.begin(), _heap.end(), HeadLess(_heads));
+}
+
+bool ExternalFrontier::next(
+    FrontierRecord &record,
+    bool &newForm)
+{
+  if (_runs.empty())
+  {
+    if (_bufferPos == _buffer.size()) return false;
+    record = _buffer[_bufferPos++];
+  } else {
+    if (_heap.empty()) return false;
+    unsigned int run = _heap[0];
+    record = _heads[run];
+    if (!readRecord(_readers[run], _heads[run]))
+    {
+      _heap[0] = _heap.back();
+      _heap.pop_back();
+    }
+    siftDown();
+  }
+
+  newForm = !_hasLast || record.key != _lastKey;
+  if (newForm) _lastKey = record.key;
+  _hasLast = true;
+  return true;
+}
+
+void ExternalFrontier::clear()
+{
+  _readers.clear();
+  for (std::size_t r = 0; r < _runs.size(); r++)
+    std::remove(_runs[r].c_str());
+  _runs.clear();
+  _heads.clear();
+  _heap.clear();
+  _buffer.clear();
+  _bufferBytes = 0;
+  _bufferPos = 0;
+  _nbRecords = 0;
+  _hasLast = false;
+}
+
+void ExternalFrontier::siftDown()
+{
+  std::size_t i = 0;
+  while (true)
+  {
+    std::size_t smallest = i, left = 2 * i + 1, right = left + 1;
+    if (left < _heap.size() && _heads[_heap[left]] < _heads[_heap[smallest]])
+      smallest = left;
+    if (right < _heap.size() && _heads[_heap[right]] < _heads[_heap[smallest]])
+      smallest = right;
+    if (smallest == i) return;
+    std::swap(_heap[i], _heap[smallest]);
+    i = smallest;
+  }
+}
+
+void ExternalFrontier::writeRecord(std::ostream &os, const FrontierRecord &record)
+{
+  boost::uint64_t nbBits = record.key.size();
+  os.write(reinterpret_cast<const char *>(&nbBits), sizeof(nbBits));
+  os.write(reinterpret_cast<const char *>(record.key.blocks()),
+      record.key.num_blocks() * sizeof(Form::block_type));
+  os.write(reinterpret_cast<const char *>(&record.seq), sizeof(record.seq));
+  os.write(reinterpret_cast<const char *>(&record.parent), sizeof(record.parent));
+  os.write(reinterpret_cast<const char *>(&record.mitoser), sizeof(record.mitoser));
+  os.write(&record.control, sizeof(record.control));
+  os.write(reinterpret_cast<const char *>(&record.symmetry),
+      sizeof(record.symmetry));
+}
+
+bool ExternalFrontier::readRecord(std::istream &is, FrontierRecord &record)
+{
+  boost::uint64_t nbBits;
+  if (!is.read(reinterpret_cast<char *>(&nbBits), sizeof(nbBits))) return false;
+  record.key.resize(nbBits);
+  is.read(reinterpret_cast<char *>(record.key.blocks()),
+      record.key.num_blocks() * sizeof(Form::block_type));
+  is.read(reinterpret_cast<char *>(&record.seq), sizeof(record.seq));
+  is.read(reinterpret_cast<char *>(&record.parent), sizeof(record.parent));
+  is.read(reinterpret_cast<char *>(&record.mitoser), sizeof(record.mitoser));
+  is.read(&record.control, sizeof(record.control));
+  is.read(reinterpret_cast<char *>(&record.symmetry), sizeof(record.symmetry));
+  if (!is) throw std::runtime_error("truncated run file");
+  return true;
+}
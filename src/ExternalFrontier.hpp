@@ -0,0 +1,171 @@
+/**
+ * @file ExternalFrontier.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef EXTERNALFRONTIER_HPP
+#define EXTERNALFRONTIER_HPP
+
+/* std include */
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/* boost include */
+#include <boost/cstdint.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+/* project include */
+#include "Form.hpp"
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief A child of a timestep, as kept by ExternalFrontier
+ * The child form itself is not kept : it is the form of the parent with the
+ * daughter cell of the mitosis.
+ */
+/* -----------------------------------------------------------*/
+struct FrontierRecord
+{
+  Form key; /*!< canonical key of the child*/
+  boost::uint64_t seq; /*!< rank of the child in the timestep*/
+  boost::uint32_t parent; /*!< index of the parent in the timestep*/
+  boost::uint32_t mitoser; /*!< position of the mother cell*/
+  char control; /*!< direction of the mitosis*/
+  boost::uint8_t symmetry; /*!< Symmetry of the child which is the key*/
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Order of the runs : by key, then in the order of addition
+   */
+  /* -----------------------------------------------------------*/
+  bool operator<(const FrontierRecord &other) const
+  {
+    if (key != other.key) return key < other.key;
+    return seq < other.seq;
+  }
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Children of a timestep deduplicated by sorting, out of core
+ * The children are buffered until their size reaches the memory budget, the
+ * buffer is then sorted by key and written to a run file. Once every child
+ * is added, the runs are merged : the children come back sorted by key, so
+ * the duplicates of a form follow its first occurrence. Only the buffer and
+ * one record per run are held in memory.
+ */
+/* -----------------------------------------------------------*/
+class ExternalFrontier
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Constructor
+   *
+   * @param directory : directory of the run files, which may be shared
+   * @param memoryBudget : size of the buffer in bytes, 0 never writes runs
+   */
+  /* -----------------------------------------------------------*/
+  ExternalFrontier(
+      const std::string &directory,
+      std::size_t memoryBudget);
+  virtual ~ExternalFrontier();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Add a child of the timestep
+   *
+   * @param[in] key : canonical key of the child, see Environment::canonicalForm
+   * @param[in] parent : index of the parent in the timestep
+   * @param[in] control : direction of the mitosis
+   * @param[in] mitoser : position of the mother cell
+   * @param[in] symmetry : Symmetry of the child which is the key
+   */
+  /* -----------------------------------------------------------*/
+  void add(
+      const Form &key,
+      std::size_t parent,
+      char control,
+      unsigned int mitoser,
+      unsigned int symmetry);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Stop adding children and start reading them back sorted
+   */
+  /* -----------------------------------------------------------*/
+  void merge();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Read the next child in key order
+   *
+   * @param[out] record : the child
+   * @param[out] newForm : true for the first child of a key
+   *
+   * @return false once every child has been read
+   */
+  /* -----------------------------------------------------------*/
+  bool next(
+      FrontierRecord &record,
+      bool &newForm);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Forget every child and remove the run files, for the next timestep
+   */
+  /* -----------------------------------------------------------*/
+  void clear();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Number of runs written since the last clear
+   */
+  /* -----------------------------------------------------------*/
+  unsigned int getNbRuns() const { return _runs.size(); }
+
+private:
+  ExternalFrontier(const ExternalFrontier &);
+  ExternalFrontier &operator=(const ExternalFrontier &);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Sort the buffer and write it to a new run file
+   */
+  /* -----------------------------------------------------------*/
+  void spill();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Reorder _heap after the head of the run on top changed
+   */
+  /* -----------------------------------------------------------*/
+  void siftDown();
+
+  static void writeRecord(std::ostream &os, const FrontierRecord &record);
+  static bool readRecord(std::istream &is, FrontierRecord &record);
+
+  std::string _directory;
+  std::string _runPrefix; /*!< name of the run files, before their number*/
+  std::size_t _memoryBudget;
+
+  std::vector<FrontierRecord> _buffer; /*!< children not written yet*/
+  std::size_t _bufferBytes; /*!< memory used by the buffer*/
+  std::size_t _bufferPos; /*!< next child to read when no run is written*/
+  boost::uint64_t _nbRecords; /*!< children added since the last clear*/
+
+  /* merge of the runs */
+  std::vector<std::string> _runs; /*!< names of the run files*/
+  boost::ptr_vector<std::ifstream> _readers;
+  std::vector<FrontierRecord> _heads; /*!< next child of each run*/
+  std::vector<unsigned int> _heap; /*!< runs by head, smallest first*/
+
+  Form _lastKey; /*!< key of the last child read*/
+  bool _hasLast;
+};
+
+#endif
@@ -0,0 +1,256 @@
+/**
+ * @file Form.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "Form.hpp"
+
+#include <algorithm>
+
+#include <boost/functional/hash.hpp>
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Number of set bits of a block
+ */
+/* -----------------------------------------------------------*/
+static unsigned int popCount(Form::block_type block)
+{
+#ifdef __GNUC__
+  return __builtin_popcountll(block);
+#else
+  unsigned int nb = 0;
+  for (; block; block &= block - 1) nb++;
+  return nb;
+#endif
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Index of the lowest set bit of a non null block
+ */
+/* -----------------------------------------------------------*/
+static unsigned int lowestSetBit(Form::block_type block)
+{
+#ifdef __GNUC__
+  return __builtin_ctzll(block);
+#else
+  unsigned int bit = 0;
+  while (!(block & 1))
+  {
+    block >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+Form::Form() :
+  _nbBits(0),
+  _blocks()
+{
+}
+
+Form::Form(size_type nbBits, unsigned long value) :
+  _nbBits(nbBits),
+  _blocks(blockCount(nbBits), 0)
+{
+  if (!_blocks.empty())
+  {
+    _blocks[0] = value;
+    clearUnusedBits();
+  }
+}
+
+void Form::clearUnusedBits()
+{
+  unsigned int used = _nbBits % bits_per_block;
+  if (used) _blocks.back() &= ((block_type)1 << used) - 1;
+}
+
+void Form::resize(size_type nbBits, bool value)
+{
+  size_type oldBits = _nbBits;
+  _blocks.resize(blockCount(nbBits), value ? ~(block_type)0 : 0);
+  _nbBits = nbBits;
+  // fill the end of the old last block
+  if (value && nbBits > oldBits && oldBits % bits_per_block)
+    _blocks[oldBits / bits_per_block] |= ~(block_type)0 << (oldBits % bits_per_block);
+  clearUnusedBits();
+}
+
+Form &Form::reset()
+{
+  std::fill(_blocks.begin(), _blocks.end(), 0);
+  return *this;
+}
+
+Form::size_type Form::count() const
+{
+  size_type nb = 0;
+  for (size_type b = 0; b < _blocks.size(); b++)
+    nb += popCount(_blocks[b]);
+  return nb;
+}
+
+bool Form::any() const
+{
+  for (size_type b = 0; b < _blocks.size(); b++)
+    if (_blocks[b]) return true;
+  return false;
+}
+
+Form::size_type Form::find_first() const
+{
+  for (size_type b = 0; b < _blocks.size(); b++)
+  {
+    if (_blocks[b]) return b * bits_per_block + lowestSetBit(_blocks[b]);
+  }
+  return npos;
+}
+
+Form::size_type Form::find_next(size_type pos) const
+{
+  ++pos;
+  if (pos >= _nbBits) return npos;
+
+  size_type b = pos / bits_per_block;
+  // ignore the bits up to pos in the first block
+  block_type block = _blocks[b] & (~(block_type)0 << (pos % bits_per_block));
+  while (!block)
+  {
+    if (++b == _blocks.size()) return npos;
+    block = _blocks[b];
+  }
+  return b * bits_per_block + lowestSetBit(block);
+}
+
+Form &Form::operator&=(const Form &other)
+{
+  for (size_type b = 0; b < _blocks.size(); b++)
+    _blocks[b] &= other._blocks[b];
+  return *this;
+}
+
+Form &Form::operator|=(const Form &other)
+{
+  for (size_type b = 0; b < _blocks.size(); b++)
+    _blocks[b] |= other._blocks[b];
+  return *this;
+}
+
+Form &Form::operator^=(const Form &other)
+{
+  for (size_type b = 0; b < _blocks.size(); b++)
+    _blocks[b] ^= other._blocks[b];
+  return *this;
+}
+
+Form &Form::operator<<=(size_type n)
+{
+  if (n >= _nbBits) return reset();
+
+  size_type shift = n / bits_per_block;
+  unsigned int bits = n % bits_per_block;
+  // move the blocks from the last one so that sources are read before being
+  // overwritten
+  for (size_type b = _blocks.size(); b-- > shift;)
+  {
+    block_type block = _blocks[b - shift] << bits;
+    if (bits && b > shift)
+      block |= _blocks[b - shift - 1] >> (bits_per_block - bits);
+    _blocks[b] = block;
+  }
+  std::fill(_blocks.begin(), _blocks.begin() + shift, 0);
+  clearUnusedBits();
+  return *this;
+}
+
+Form &Form::operator>>=(size_type n)
+{
+  if (n >= _nbBits) return reset();
+
+  size_type shift = n / bits_per_block;
+  unsigned int bits = n % bits_per_block;
+  size_type last = _blocks.size() - shift;
+  for (size_type b = 0; b < last; b++)
+  {
+    block_type block = _blocks[b + shift] >> bits;
+    if (bits && b + shift + 1 < _blocks.size())
+      block |= _blocks[b + shift + 1] << (bits_per_block - bits);
+    _blocks[b] = block;
+  }
+  std::fill(_blocks.begin() + last, _blocks.end(), 0);
+  return *this;
+}
+
+Form Form::operator<<(size_type n) const
+{
+  Form result(*this);
+  return result <<= n;
+}
+
+Form Form::operator>>(size_type n) const
+{
+  Form result(*this);
+  return result >>= n;
+}
+
+Form Form::operator~() const
+{
+  Form result(*this);
+  for (size_type b = 0; b < result._blocks.size(); b++)
+    result._blocks[b] = ~result._blocks[b];
+  result.clearUnusedBits();
+  return result;
+}
+
+bool Form::operator==(const Form &other) const
+{
+  return _nbBits == other._nbBits &&
+         std::equal(_blocks.begin(), _blocks.end(), other._blocks.begin());
+}
+
+bool Form::operator<(const Form &other) const
+{
+  if (_nbBits != other._nbBits) return _nbBits < other._nbBits;
+  for (size_type b = _blocks.size(); b-- > 0;)
+  {
+    if (_blocks[b] != other._blocks[b]) return _blocks[b] < other._blocks[b];
+  }
+  return false;
+}
+
+Form operator&(const Form &a, const Form &b)
+{
+  Form result(a);
+  return result &= b;
+}
+
+Form operator|(const Form &a, const Form &b)
+{
+  Form result(a);
+  return result |= b;
+}
+
+Form operator^(const Form &a, const Form &b)
+{
+  Form result(a);
+  return result ^= b;
+}
+
+std::size_t hash_value(const Form &form)
+{
+  std::size_t seed = form.size();
+  boost::hash_range(seed, form.blocks(), form.blocks() + form.num_blocks());
+  return seed;
+}
+
+std::ostream &operator<<(std::ostream &os, const Form &form)
+{
+  for (Form::size_type pos = form.size(); pos-- > 0;)
+    os << (form[pos] ? '1' : '0');
+  return os;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file Form.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef FORM_HPP
+#define FORM_HPP
+
+/* std include */
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+/* boost include */
+#include <boost/cstdint.hpp>
+#include <boost/container/small_vector.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Fixed size set of bits describing the cells of a form
+ * Form offers the part of the boost::dynamic_bitset interface used on forms.
+ * Bits are stored in 64 bits blocks kept inside the object for forms of up to
+ * INLINE_BITS cells, bigger forms spill to the heap. Copying a form of a grid
+ * of up to 16x16 cells therefore never allocates.
+ */
+/* -----------------------------------------------------------*/
+class Form
+{
+public:
+  typedef boost::uint64_t block_type;
+  typedef std::size_t size_type;
+
+  static const unsigned int bits_per_block = 64;
+  static const size_type npos = static_cast<size_type>(-1);
+  static const unsigned int INLINE_BLOCKS = 4; /*!< blocks stored inline*/
+  static const unsigned int INLINE_BITS = INLINE_BLOCKS * bits_per_block;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Default constructor, empty form of 0 cell
+   */
+  /* -----------------------------------------------------------*/
+  Form();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Constructor
+   *
+   * @param nbBits : number of cells of the grid
+   * @param value : initial value of the first cells, as for dynamic_bitset
+   */
+  /* -----------------------------------------------------------*/
+  explicit Form(size_type nbBits, unsigned long value = 0);
+
+  size_type size() const { return _nbBits; }
+  size_type num_blocks() const { return _blocks.size(); }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Direct access to the blocks
+   * Bit pos is bit pos % 64 of block pos / 64, the bits of the last block
+   * beyond size() are always 0.
+   */
+  /* -----------------------------------------------------------*/
+  const block_type *blocks() const { return _blocks.data(); }
+  block_type *blocks() { return _blocks.data(); }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Change the number of cells, new cells are set to value
+   */
+  /* -----------------------------------------------------------*/
+  void resize(size_type nbBits, bool value = false);
+
+  bool test(size_type pos) const
+  {
+    return (_blocks[pos / bits_per_block] >> (pos % bits_per_block)) & 1;
+  }
+  bool operator[](size_type pos) const { return test(pos); }
+
+  Form &set(size_type pos)
+  {
+    _blocks[pos / bits_per_block] |= (block_type)1 << (pos % bits_per_block);
+    return *this;
+  }
+  Form &set(size_type pos, bool value) { return value ? set(pos) : reset(pos); }
+  Form &reset(size_type pos)
+  {
+    _blocks[pos / bits_per_block] &= ~((block_type)1 << (pos % bits_per_block));
+    return *this;
+  }
+  Form &reset();
+
+  size_type count() const;
+  bool any() const;
+  bool none() const { return !any(); }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Find the first cell, or the first cell after pos
+   *
+   * @return the position of the cell, npos if there is none
+   */
+  /* -----------------------------------------------------------*/
+  size_type find_first() const;
+  size_type find_next(size_type pos) const;
+
+  Form &operator&=(const Form &other);
+  Form &operator|=(const Form &other);
+  Form &operator^=(const Form &other);
+  Form &operator<<=(size_type n);
+  Form &operator>>=(size_type n);
+  Form operator<<(size_type n) const;
+  Form operator>>(size_type n) const;
+  Form operator~() const;
+
+  bool operator==(const Form &other) const;
+  bool operator!=(const Form &other) const { return !(*this == other); }
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Total order : by size, then as numbers, bit size() - 1 being the
+   * most significant
+   */
+  /* -----------------------------------------------------------*/
+  bool operator<(const Form &other) const;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Serialization, same layout as the one used for dynamic_bitset :
+   * the number of bits then the vector of blocks
+   */
+  /* -----------------------------------------------------------*/
+  template <class Archive>
+  void save(Archive &ar, const unsigned int /*version*/) const
+  {
+    size_t num_bits = _nbBits;
+    std::vector<block_type> blocks(_blocks.begin(), _blocks.end());
+    ar & num_bits & blocks;
+  }
+  template <class Archive>
+  void load(Archive &ar, const unsigned int /*version*/)
+  {
+    size_t num_bits;
+    std::vector<block_type> blocks;
+    ar & num_bits & blocks;
+    _nbBits = num_bits;
+    _blocks.assign(blocks.begin(), blocks.end());
+    _blocks.resize(blockCount(_nbBits), 0);
+    clearUnusedBits();
+  }
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+private:
+  static size_type blockCount(size_type nbBits)
+  {
+    return (nbBits + bits_per_block - 1) / bits_per_block;
+  }
+  void clearUnusedBits();
+
+  size_type _nbBits; /*!< number of cells*/
+  boost::container::small_vector< block_type, INLINE_BLOCKS > _blocks;
+};
+
+Form operator&(const Form &a, const Form &b);
+Form operator|(const Form &a, const Form &b);
+Form operator^(const Form &a, const Form &b);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Hash of a form, for boost::unordered containers
+ */
+/* -----------------------------------------------------------*/
+std::size_t hash_value(const Form &form);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Print the bits from the last one to the first one, as for
+ * dynamic_bitset
+ */
+/* -----------------------------------------------------------*/
+std::ostream &operator<<(std::ostream &os, const Form &form);
+
+#endif
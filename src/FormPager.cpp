@@ -0,0 +1,117 @@
+/**
+ * @file FormPager.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "FormPager.hpp"
+
+#include <boost/bind/bind.hpp>
+
+#include "Trace.hpp"
+
+FormPager::FormPager(
+    const FormSource &forms,
+    int window) :
+  _forms(forms),
+  _window(window),
+  _center(0),
+  _nbMoves(0),
+  _stopping(false)
+{
+  // the neighbours first, then the form window away, then the others by
+  // distance : the viewer steps by 1 or by window
+  _order.push_back(0);
+  if (_window >= 1) {
+    _order.push_back(1);
+    _order.push_back(-1);
+  }
+  if (_window > 1) {
+    _order.push_back(_window);
+    _order.push_back(-_window);
+  }
+  for (int d = 2; d < _window; d++) {
+    _order.push_back(d);
+    _order.push_back(-d);
+  }
+
+  if (_forms.isConcurrent())
+    _thread = boost::thread(boost::bind(&FormPager::run, this));
+}
+
+FormPager::~FormPager()
+{
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    _stopping = true;
+    _moved.notify_all();
+  }
+  if (_thread.joinable()) _thread.join();
+}
+
+boost::shared_ptr<const PagedForm> FormPager::getForm(int index)
+{
+  boost::shared_ptr<const PagedForm> page;
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    _center = index;
+    _nbMoves++;
+
+    // drop the forms out of the window
+    for (PageMap::iterator it = _pages.begin(); it != _pages.end();) {
+      if (inWindow(it->first)) ++it;
+      else _pages.erase(it++);
+    }
+
+    PageMap::const_iterator it = _pages.find(index);
+    if (it != _pages.end()) page = it->second;
+    _moved.notify_all();
+  }
+  if (page) return page;
+
+  // not loaded yet : loaded here rather than waiting for the thread
+  page = load(index);
+  boost::mutex::scoped_lock lock(_mutex);
+  if (inWindow(index)) _pages.insert(std::make_pair(index, page));
+  return page;
+}
+
+boost::shared_ptr<const PagedForm> FormPager::load(int index) const
+{
+  TraceScope scope(TRACE_VIEWER_LOAD, index);
+  boost::shared_ptr<PagedForm> page(new PagedForm);
+  _forms.getFormFromGraph(index, page->form, page->energy, page->oxygen,
+      page->glucose, page->lactate);
+  return page;
+}
+
+int FormPager::nextMissing() const
+{
+  int nbForms = _forms.getMaxNbrOfForm();
+  for (std::size_t o = 0; o < _order.size(); o++) {
+    int index = _center + _order[o];
+    if (index >= 0 && index < nbForms && !_pages.count(index)) return index;
+  }
+  return -1;
+}
+
+void FormPager::run()
+{
+  boost::mutex::scoped_lock lock(_mutex);
+  while (!_stopping) {
+    int index = nextMissing();
+    if (index < 0) {
+      // wait for the window to move
+      unsigned long nbMoves = _nbMoves;
+      while (!_stopping && nbMoves == _nbMoves) _moved.wait(lock);
+      continue;
+    }
+
+    lock.unlock();
+    boost::shared_ptr<const PagedForm> page = load(index);
+    lock.lock();
+    // the window may have moved meanwhile
+    if (inWindow(index)) _pages.insert(std::make_pair(index, page));
+  }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file FormPager.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef FORMPAGER_HPP
+#define FORMPAGER_HPP
+
+/* std include */
+#include <map>
+#include <vector>
+
+/* boost include */
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/* project include */
+#include "FormSource.hpp"
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief A form of a FormSource and its env, as loaded by FormPager
+ */
+/* -----------------------------------------------------------*/
+struct PagedForm
+{
+  graphVertex form;
+  std::vector<double> energy;
+  std::vector<double> oxygen;
+  std::vector<double> glucose;
+  std::vector<double> lactate;
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Forms of a FormSource around the form under view
+ * Only the forms at most window indexes away from the last one asked are
+ * kept. When the source can be read from several threads, a background
+ * thread loads them ahead, the nearest first, so that moving to a neighbour
+ * finds it loaded.
+ */
+/* -----------------------------------------------------------*/
+class FormPager
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Constructor
+   *
+   * @param forms : forms to load, which must outlive the pager
+   * @param window : forms loaded before and after the form asked
+   */
+  /* -----------------------------------------------------------*/
+  FormPager(
+      const FormSource &forms,
+      int window);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Stop the loading thread
+   */
+  /* -----------------------------------------------------------*/
+  ~FormPager();
+
+  int getMaxNbrOfForm() const { return _forms.getMaxNbrOfForm(); }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Get a form, loaded now if it is not loaded yet, and move the
+   * window around it
+   *
+   * @param index : index of the form
+   *
+   * @return the form, which stays valid as long as it is held
+   */
+  /* -----------------------------------------------------------*/
+  boost::shared_ptr<const PagedForm> getForm(int index);
+
+private:
+  typedef std::map< int, boost::shared_ptr<const PagedForm> > PageMap;
+
+  boost::shared_ptr<const PagedForm> load(int index) const;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Nearest form of the window not loaded, -1 if none, _mutex being
+   * locked
+   */
+  /* -----------------------------------------------------------*/
+  int nextMissing() const;
+
+  bool inWindow(int index) const
+  {
+    return index >= _center - _window && index <= _center + _window;
+  }
+
+  void run();
+
+  const FormSource &_forms;
+  int _window;
+  std::vector<int> _order; /*!< offsets from the center, by priority*/
+
+  boost::mutex _mutex;
+  boost::condition_variable _moved;
+  PageMap _pages; /*!< forms of the window loaded*/
+  int _center; /*!< last form asked*/
+  unsigned long _nbMoves;
+  bool _stopping;
+  boost::thread _thread;
+};
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file FormSource.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef FORMSOURCE_HPP
+#define FORMSOURCE_HPP
+
+/* std include */
+#include <vector>
+
+/* project include */
+#include "environment.h"
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Read access to the forms of a result and their env
+ * Implemented by GraphManager while enumerating and by ResultStore for a
+ * saved result, so that GraphViewer can show either.
+ */
+/* -----------------------------------------------------------*/
+class FormSource
+{
+public:
+  virtual ~FormSource() {}
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Number of forms of the result
+   */
+  /* -----------------------------------------------------------*/
+  virtual int getMaxNbrOfForm() const = 0;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief True if getFormFromGraph can be called from several threads at
+   * once
+   */
+  /* -----------------------------------------------------------*/
+  virtual bool isConcurrent() const { return false; }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Get a specific form and the corresponding env
+   *
+   * @param[in] index : index of the form
+   * @param[out] form : corresponding form at index
+   * @param[out] energy : corresponding energy env at index
+   * @param[out] oxygen : corresponding oxygen env at index
+   * @param[out] glucose : corresponding glucose env at index
+   * @param[out] lactate : corresponding lactate env at index
+   */
+  /* -----------------------------------------------------------*/
+  virtual void getFormFromGraph(
+      int index,
+      graphVertex &form,
+      std::vector<double> &energy,
+      std::vector<double> &oxygen,
+      std::vector<double> &glucose,
+      std::vector<double> &lactate) const = 0;
+};
+
+#endif
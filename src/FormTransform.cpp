@@ -0,0 +1,319 @@
+/**
+ * @file FormTransform.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "FormTransform.hpp"
+
+#include <algorithm>
+
+typedef graphVertex::block_type Block;
+static const unsigned int BLOCK_BITS = graphVertex::bits_per_block;
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Mask of the nbBits lowest bits of a word
+ */
+/* -----------------------------------------------------------*/
+static boost::uint64_t lowMask(unsigned int nbBits)
+{
+  return nbBits >= 64 ? ~(boost::uint64_t)0 : ((boost::uint64_t)1 << nbBits) - 1;
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Read nbBits (at most 64) bits of a block range starting at bit pos
+ */
+/* -----------------------------------------------------------*/
+static boost::uint64_t readBits(
+    const graphVertex &form,
+    size_t pos,
+    unsigned int nbBits)
+{
+  const Block *blocks = form.blocks();
+  boost::uint64_t word = 0;
+  unsigned int done = 0;
+  while (done < nbBits)
+  {
+    size_t block = (pos + done) / BLOCK_BITS;
+    unsigned int bit = (pos + done) % BLOCK_BITS;
+    if (block >= form.num_blocks()) break;
+    word |= (boost::uint64_t)(blocks[block] >> bit) << done;
+    done += BLOCK_BITS - bit;
+  }
+  return word & lowMask(nbBits);
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Write the nbBits (at most 64) lowest bits of word in a zeroed block
+ * range starting at bit pos
+ */
+/* -----------------------------------------------------------*/
+static void writeBits(
+    Block *blocks,
+    size_t pos,
+    boost::uint64_t word,
+    unsigned int nbBits)
+{
+  word &= lowMask(nbBits);
+  unsigned int done = 0;
+  while (done < nbBits)
+  {
+    size_t block = (pos + done) / BLOCK_BITS;
+    unsigned int bit = (pos + done) % BLOCK_BITS;
+    blocks[block] |= (Block)((word >> done) << bit);
+    done += BLOCK_BITS - bit;
+  }
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Mirror the width lowest bits of a row
+ * The 64 bits are reversed by swapping neighbours, then pairs, nibbles,
+ * bytes, half words and words.
+ */
+/* -----------------------------------------------------------*/
+static boost::uint64_t reverseRow(boost::uint64_t row, unsigned int width)
+{
+  row = ((row >> 1) & 0x5555555555555555ULL) | ((row & 0x5555555555555555ULL) << 1);
+  row = ((row >> 2) & 0x3333333333333333ULL) | ((row & 0x3333333333333333ULL) << 2);
+  row = ((row >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((row & 0x0F0F0F0F0F0F0F0FULL) << 4);
+  row = ((row >> 8) & 0x00FF00FF00FF00FFULL) | ((row & 0x00FF00FF00FF00FFULL) << 8);
+  row = ((row >> 16) & 0x0000FFFF0000FFFFULL) | ((row & 0x0000FFFF0000FFFFULL) << 16);
+  row = (row >> 32) | (row << 32);
+  return row >> (64 - width);
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Transpose a cropped form
+ * The bit matrix is transposed by recursively swapping the top right and
+ * bottom left blocks of side 32, 16, ... 1, each swap being done on whole
+ * rows with masks.
+ */
+/* -----------------------------------------------------------*/
+static void transposeBoard(const RowBoard &board, RowBoard &image)
+{
+  static const boost::uint64_t masks[6] = {
+    0x5555555555555555ULL, 0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL,
+    0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL, 0x00000000FFFFFFFFULL};
+  unsigned int side = std::max(board.height, board.width);
+  unsigned int n = 1, level = 0;
+  while (n < side)
+  {
+    n <<= 1;
+    level++;
+  }
+
+  std::copy(board.rows, board.rows + board.height, image.rows);
+  std::fill(image.rows + board.height, image.rows + n, 0);
+  for (unsigned int j = n >> 1; j > 0; j >>= 1)
+  {
+    level--;
+    for (unsigned int k = 0; k < n; k++)
+    {
+      if (k & j) continue;
+      boost::uint64_t t = ((image.rows[k] >> j) ^ image.rows[k + j]) & masks[level];
+      image.rows[k] ^= t << j;
+      image.rows[k + j] ^= t;
+    }
+  }
+  image.height = board.width;
+  image.width = board.height;
+  image.row = board.row;
+  image.col = board.col;
+}
+
+bool loadBoard(
+    const graphVertex &form,
+    unsigned int gridWidth,
+    RowBoard &board)
+{
+  size_t first = form.find_first();
+  if (first == graphVertex::npos) return false;
+
+  // the last cell is in the last non null block
+  const Block *blocks = form.blocks();
+  size_t lastBlock = form.num_blocks() - 1;
+  while (!blocks[lastBlock]) lastBlock--;
+  size_t last = lastBlock * BLOCK_BITS + highestBit(blocks[lastBlock]);
+
+  board.row = first / gridWidth;
+  board.height = last / gridWidth - board.row + 1;
+  if (board.height > MAX_BOARD_SIDE) return false;
+
+  boost::uint64_t columns = 0;
+  if (gridWidth <= 64)
+  {
+    // a row of the grid fits in a word
+    for (unsigned int r = 0; r < board.height; r++)
+    {
+      board.rows[r] = readBits(form, (board.row + r) * gridWidth, gridWidth);
+      columns |= board.rows[r];
+    }
+    board.col = lowestBit(columns);
+  } else {
+    // find the leftmost cell of each row, then read a word from there
+    board.col = gridWidth;
+    for (unsigned int r = 0; r < board.height; r++)
+    {
+      size_t rowStart = (board.row + r) * gridWidth;
+      size_t pos = rowStart ? form.find_next(rowStart - 1) : first;
+      if (pos < rowStart + gridWidth)
+        board.col = std::min(board.col, (unsigned int)(pos - rowStart));
+    }
+    unsigned int nbBits = std::min(64u, gridWidth - board.col);
+    for (unsigned int r = 0; r < board.height; r++)
+    {
+      size_t rowStart = (board.row + r) * gridWidth;
+      // cells beyond the word read make the bounding box too wide
+      if (nbBits == 64 && board.col + 64 < gridWidth &&
+          form.find_next(rowStart + board.col + 63) < rowStart + gridWidth)
+        return false;
+      board.rows[r] = readBits(form, rowStart + board.col, nbBits);
+      columns |= board.rows[r];
+    }
+  }
+
+  board.width = highestBit(columns) + 1;
+  if (gridWidth <= 64)
+  {
+    board.width -= board.col;
+    for (unsigned int r = 0; r < board.height; r++)
+      board.rows[r] >>= board.col;
+  }
+  return true;
+}
+
+unsigned int storeBoard(
+    const RowBoard &board,
+    unsigned int row,
+    unsigned int col,
+    unsigned int gridHeight,
+    unsigned int gridWidth,
+    graphVertex &form)
+{
+  size_t maxSize = gridHeight * gridWidth;
+  unsigned int nbCells = 0;
+
+  form.resize(maxSize);
+  form.reset();
+
+  if (col < gridWidth)
+  {
+    unsigned int nbBits = std::min(board.width, gridWidth - col);
+    for (unsigned int r = 0; r < board.height && row + r < gridHeight; r++)
+    {
+      boost::uint64_t word = board.rows[r] & lowMask(nbBits);
+      writeBits(form.blocks(), (row + r) * gridWidth + col, word, nbBits);
+      for (; word; word &= word - 1) nbCells++;
+    }
+  }
+
+  return nbCells;
+}
+
+void transformBoard(
+    const RowBoard &board,
+    Symmetry sym,
+    RowBoard &image)
+{
+  RowBoard transposed;
+  const RowBoard *src = &board;
+  if (sym & TRANSPOSE)
+  {
+    transposeBoard(board, transposed);
+    src = &transposed;
+  }
+
+  image.height = src->height;
+  image.width = src->width;
+  image.row = board.row;
+  image.col = board.col;
+  for (unsigned int r = 0; r < image.height; r++)
+  {
+    boost::uint64_t word = src->rows[(sym & HOR_SYM) ? image.height - 1 - r : r];
+    image.rows[r] = (sym & VERT_SYM) ? reverseRow(word, image.width) : word;
+  }
+}
+
+void allImages(
+    const RowBoard &board,
+    RowBoard images[NB_SYMMETRIES])
+{
+  // images[TRANSPOSE] is the transposed form, images[VERT_SYM] and
+  // images[ROTATION_90] the mirrored rows of the form and of its transpose
+  transposeBoard(board, images[TRANSPOSE]);
+  for (unsigned int s = 0; s < NB_SYMMETRIES; s++)
+  {
+    images[s].height = (s & TRANSPOSE) ? board.width : board.height;
+    images[s].width = (s & TRANSPOSE) ? board.height : board.width;
+    images[s].row = board.row;
+    images[s].col = board.col;
+  }
+  for (unsigned int r = 0; r < board.height; r++)
+  {
+    images[IDENTITY].rows[r] = board.rows[r];
+    images[VERT_SYM].rows[r] = reverseRow(board.rows[r], board.width);
+  }
+  for (unsigned int r = 0; r < board.width; r++)
+    images[ROTATION_90].rows[r] = reverseRow(images[TRANSPOSE].rows[r], board.height);
+
+  // the remaining images read the same rows bottom up
+  for (unsigned int s = HOR_SYM; s < NB_SYMMETRIES; s++)
+  {
+    if (!(s & HOR_SYM)) continue;
+    const RowBoard &src = images[s & ~HOR_SYM];
+    for (unsigned int r = 0; r < src.height; r++)
+      images[s].rows[r] = src.rows[src.height - 1 - r];
+  }
+}
+
+int compareBoards(
+    const RowBoard &a,
+    const RowBoard &b)
+{
+  if (a.height != b.height) return a.height < b.height ? -1 : 1;
+  if (a.width != b.width) return a.width < b.width ? -1 : 1;
+  for (unsigned int r = 0; r < a.height; r++)
+  {
+    if (a.rows[r] != b.rows[r]) return a.rows[r] < b.rows[r] ? -1 : 1;
+  }
+  return 0;
+}
+
+Symmetry composeSymmetries(
+    Symmetry after,
+    Symmetry before)
+{
+  // compositions[after][before]
+  static const Symmetry compositions[NB_SYMMETRIES][NB_SYMMETRIES] = {
+    {IDENTITY, VERT_SYM, HOR_SYM, ROTATION_180,
+     TRANSPOSE, ROTATION_90, ROTATION_270, ANTI_TRANSPOSE},
+    {VERT_SYM, IDENTITY, ROTATION_180, HOR_SYM,
+     ROTATION_90, TRANSPOSE, ANTI_TRANSPOSE, ROTATION_270},
+    {HOR_SYM, ROTATION_180, IDENTITY, VERT_SYM,
+     ROTATION_270, ANTI_TRANSPOSE, TRANSPOSE, ROTATION_90},
+    {ROTATION_180, HOR_SYM, VERT_SYM, IDENTITY,
+     ANTI_TRANSPOSE, ROTATION_270, ROTATION_90, TRANSPOSE},
+    {TRANSPOSE, ROTATION_270, ROTATION_90, ANTI_TRANSPOSE,
+     IDENTITY, HOR_SYM, VERT_SYM, ROTATION_180},
+    {ROTATION_90, ANTI_TRANSPOSE, TRANSPOSE, ROTATION_270,
+     VERT_SYM, ROTATION_180, IDENTITY, HOR_SYM},
+    {ROTATION_270, TRANSPOSE, ANTI_TRANSPOSE, ROTATION_90,
+     HOR_SYM, IDENTITY, ROTATION_180, VERT_SYM},
+    {ANTI_TRANSPOSE, ROTATION_90, ROTATION_270, TRANSPOSE,
+     ROTATION_180, VERT_SYM, HOR_SYM, IDENTITY}};
+  return compositions[after][before];
+}
+
+Symmetry inverseSymmetry(Symmetry sym)
+{
+  // the quarter turns are the only symmetries which are not their own inverse
+  if (sym == ROTATION_90) return ROTATION_270;
+  if (sym == ROTATION_270) return ROTATION_90;
+  return sym;
+}
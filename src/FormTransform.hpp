@@ -0,0 +1,190 @@
+/**
+ * @file FormTransform.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef FORMTRANSFORM_HPP
+#define FORMTRANSFORM_HPP
+
+/* boost include */
+#include <boost/cstdint.hpp>
+
+/* project include */
+#include "environment.h"
+
+/* Maximum height and width of a bounding box handled by a RowBoard */
+const unsigned int MAX_BOARD_SIDE = 64;
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief The 8 rotations and symmetries of the square
+ * Images are given for a form of bounding box height x width,
+ * a cell (r, c) is moved to :
+ */
+/* -----------------------------------------------------------*/
+enum Symmetry
+{
+  IDENTITY,       /*!< (r, c)*/
+  VERT_SYM,       /*!< (r, width-1-c)*/
+  HOR_SYM,        /*!< (height-1-r, c)*/
+  ROTATION_180,   /*!< (height-1-r, width-1-c)*/
+  TRANSPOSE,      /*!< (c, r)*/
+  ROTATION_90,    /*!< (c, height-1-r)*/
+  ROTATION_270,   /*!< (width-1-c, r)*/
+  ANTI_TRANSPOSE, /*!< (width-1-c, height-1-r)*/
+  NB_SYMMETRIES
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief A form cropped to its bounding box, one machine word per row
+ * Bit c of rows[r] is the cell at row r and column c of the bounding box.
+ * Rows from height to MAX_BOARD_SIDE are not used.
+ */
+/* -----------------------------------------------------------*/
+struct RowBoard
+{
+  unsigned int height; /*!< height of the bounding box*/
+  unsigned int width; /*!< width of the bounding box*/
+  unsigned int row; /*!< row of the bounding box in the grid*/
+  unsigned int col; /*!< column of the bounding box in the grid*/
+  boost::uint64_t rows[MAX_BOARD_SIDE]; /*!< cells of each row*/
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Index of the lowest set bit of a non null word
+ */
+/* -----------------------------------------------------------*/
+inline unsigned int lowestBit(boost::uint64_t word)
+{
+#ifdef __GNUC__
+  return __builtin_ctzll(word);
+#else
+  unsigned int bit = 0;
+  while (!(word & 1))
+  {
+    word >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Index of the highest set bit of a non null word
+ */
+/* -----------------------------------------------------------*/
+inline unsigned int highestBit(boost::uint64_t word)
+{
+#ifdef __GNUC__
+  return 63 - __builtin_clzll(word);
+#else
+  unsigned int bit = 0;
+  while (word >>= 1) bit++;
+  return bit;
+#endif
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Crop a form of the grid to its bounding box
+ *
+ * @param[in] form : form to crop
+ * @param[in] gridWidth : width of the grid
+ * @param[out] board : cropped form
+ *
+ * @return false if the form is empty or its bounding box is bigger than
+ * MAX_BOARD_SIDE
+ */
+/* -----------------------------------------------------------*/
+bool loadBoard(
+    const graphVertex &form,
+    unsigned int gridWidth,
+    RowBoard &board);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Write a cropped form in a grid
+ *
+ * @param[in] board : cropped form
+ * @param[in] row : row of the grid receiving the first row of the board
+ * @param[in] col : column of the grid receiving the first column of the board
+ * @param[in] gridHeight : height of the grid
+ * @param[in] gridWidth : width of the grid
+ * @param[out] form : form of gridHeight x gridWidth cells
+ *
+ * @return the number of cells written, cells falling outside of the grid
+ * are dropped
+ */
+/* -----------------------------------------------------------*/
+unsigned int storeBoard(
+    const RowBoard &board,
+    unsigned int row,
+    unsigned int col,
+    unsigned int gridHeight,
+    unsigned int gridWidth,
+    graphVertex &form);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Compute the image of a cropped form by one symmetry
+ *
+ * @param[in] board : cropped form
+ * @param[in] sym : symmetry to apply
+ * @param[out] image : cropped image, must not be board
+ */
+/* -----------------------------------------------------------*/
+void transformBoard(
+    const RowBoard &board,
+    Symmetry sym,
+    RowBoard &image);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Compute the 8 images of a cropped form in one pass
+ *
+ * @param[in] board : cropped form
+ * @param[out] images : images indexed by Symmetry
+ * The form is transposed and its rows are reversed once, every image is
+ * then a copy of one of these four boards in natural or reversed row order.
+ */
+/* -----------------------------------------------------------*/
+void allImages(
+    const RowBoard &board,
+    RowBoard images[NB_SYMMETRIES]);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Total order on cropped forms
+ *
+ * @return negative, 0 or positive if a is lower, equal or greater than b
+ * Boards are compared by height, then width, then rows.
+ */
+/* -----------------------------------------------------------*/
+int compareBoards(
+    const RowBoard &a,
+    const RowBoard &b);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Symmetry moving a form as before then after do, up to a
+ * translation
+ */
+/* -----------------------------------------------------------*/
+Symmetry composeSymmetries(
+    Symmetry after,
+    Symmetry before);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Symmetry moving the image of a form by sym back onto the form, up
+ * to a translation
+ */
+/* -----------------------------------------------------------*/
+Symmetry inverseSymmetry(Symmetry sym);
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file FormWriter.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "FormWriter.hpp"
+
+#include <iostream>
+
+#include <boost/bind/bind.hpp>
+
+static const std::size_t BUFFER_SIZE = 1 << 20;
+static const char FORM_FILE_MAGIC[8] = "MCELLFF";
+static const char GRAPH_FILE_MAGIC[8] = "MCELLGF";
+
+void writeFormGrid(
+    std::ostream &os,
+    const Form &form,
+    unsigned int width,
+    unsigned int height,
+    unsigned int formLabel)
+{
+  unsigned int l = height;
+  while (!(l == 1)) {
+    unsigned int c = 1;
+    while (c < width) {
+      os << form[l * width - c] << "     ";
+      c++;
+    }
+    os << form[l * width - c];
+    os << "\n\n\n";
+    l--;
+  }
+
+  unsigned int c = 1;
+  while (c < width) {
+    os << form[l * width - c] << "     ";
+    c++;
+  }
+
+  os << form[l * width - c] << "\n";
+  os << "=================" << "\n";
+  os << "N? : " << formLabel;
+  os << "\n";
+  os << "=================" << "\n";
+}
+
+FormWriter::FormWriter(
+    const std::string &formFileName,
+    const std::string &graphFileName,
+    unsigned int width,
+    unsigned int height,
+    FormFileFormat format) :
+  _width(width),
+  _height(height),
+  _format(format),
+  _formBuffer(BUFFER_SIZE),
+  _graphBuffer(BUFFER_SIZE),
+  _timestep(0),
+  _closing(false),
+  _closed(false)
+{
+  // the buffers are given before opening, for every implementation to use
+  // them
+  _formFile.rdbuf()->pubsetbuf(&_formBuffer[0], _formBuffer.size());
+  _graphFile.rdbuf()->pubsetbuf(&_graphBuffer[0], _graphBuffer.size());
+
+  // the text formFile keeps the forms of the previous runs
+  std::ios::openmode formMode = std::ios::out;
+  if (_format == TEXT_FORMAT) formMode |= std::ios::app;
+  if (_format == BINARY_FORMAT) formMode |= std::ios::binary;
+  std::ios::openmode graphMode = std::ios::out;
+  if (_format == BINARY_FORMAT) graphMode |= std::ios::binary;
+
+  _formFile.open(formFileName.c_str(), formMode);
+  if (!_formFile)
+    std::cerr << "Impossible d'ouvrir le fichier !" << std::endl;
+  _graphFile.open(graphFileName.c_str(), graphMode);
+  if (!_graphFile)
+    std::cerr << "Impossible d'ouvrir le fichier !" << std::endl;
+
+  if (_format == BINARY_FORMAT) {
+    writeHeader(_formFile, FORM_FILE_MAGIC);
+    writeHeader(_graphFile, GRAPH_FILE_MAGIC);
+  }
+
+  _thread = boost::thread(boost::bind(&FormWriter::run, this));
+}
+
+FormWriter::~FormWriter()
+{
+  close();
+}
+
+void FormWriter::addForm(const Form &form)
+{
+  push(GRAPH_FORM, 0, form);
+}
+
+void FormWriter::endTimestep()
+{
+  push(END_TIMESTEP, 0, Form());
+}
+
+void FormWriter::addFinalForm(
+    const Form &form,
+    unsigned int formLabel)
+{
+  push(FINAL_FORM, formLabel, form);
+}
+
+bool FormWriter::close()
+{
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    if (_closed) return _formFile && _graphFile;
+    _closing = true;
+  }
+  _ready.notify_one();
+  _thread.join();
+  _closed = true;
+
+  _formFile.close();
+  _graphFile.close();
+  return _formFile && _graphFile;
+}
+
+void FormWriter::push(
+    RecordKind kind,
+    unsigned int label,
+    const Form &form)
+{
+  bool wasEmpty;
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    wasEmpty = _pending.empty();
+    _pending.push_back(Record());
+    Record &record = _pending.back();
+    record.kind = kind;
+    record.label = label;
+    record.form = form;
+  }
+  // the thread only waits when there is nothing to write
+  if (wasEmpty) _ready.notify_one();
+}
+
+void FormWriter::run()
+{
+  std::vector<Record> records;
+  for (;;) {
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      while (_pending.empty() && !_closing) _ready.wait(lock);
+      if (_pending.empty()) break;
+      // take every record added at once, the next ones being added to the
+      // emptied vector meanwhile
+      records.swap(_pending);
+    }
+    for (std::size_t r = 0; r < records.size(); r++) write(records[r]);
+    records.clear();
+  }
+  _formFile.flush();
+  _graphFile.flush();
+}
+
+void FormWriter::write(const Record &record)
+{
+  switch (record.kind) {
+  case GRAPH_FORM:
+    if (_format == TEXT_FORMAT)
+      _graphFile << record.form << "     ";
+    else if (_format == COMPACT_FORMAT)
+      _graphFile << _timestep << " " << record.form << "\n";
+    else
+      writeBinary(_graphFile, _timestep, record.form);
+    break;
+  case END_TIMESTEP:
+    if (_format == TEXT_FORMAT) _graphFile << "\n\n\n";
+    _timestep++;
+    break;
+  case FINAL_FORM:
+    if (_format == TEXT_FORMAT)
+      writeFormGrid(_formFile, record.form, _width, _height, record.label);
+    else if (_format == COMPACT_FORMAT)
+      _formFile << record.label << " " << record.form << "\n";
+    else
+      writeBinary(_formFile, record.label, record.form);
+    break;
+  }
+}
+
+void FormWriter::writeHeader(
+    std::ostream &os,
+    const char *magic)
+{
+  boost::uint32_t values[3];
+  values[0] = _width;
+  values[1] = _height;
+  values[2] = Form(_width * _height).num_blocks();
+  os.write(magic, 8);
+  os.write(reinterpret_cast<const char *>(values), sizeof(values));
+}
+
+void FormWriter::writeBinary(
+    std::ostream &os,
+    boost::uint32_t label,
+    const Form &form)
+{
+  os.write(reinterpret_cast<const char *>(&label), sizeof(label));
+  os.write(reinterpret_cast<const char *>(form.blocks()),
+      form.num_blocks() * sizeof(Form::block_type));
+}
@@ -0,0 +1,183 @@
+/**
+ * @file FormWriter.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef FORMWRITER_HPP
+#define FORMWRITER_HPP
+
+/* std include */
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* boost include */
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/* project include */
+#include "Form.hpp"
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Layout of formFile and graphFile
+ */
+/* -----------------------------------------------------------*/
+enum FormFileFormat
+{
+  TEXT_FORMAT, /*!< formFile as a grid per form, appended to the file*/
+  COMPACT_FORMAT, /*!< a line per form : label or timestep, then the cells*/
+  BINARY_FORMAT /*!< a header then, per form, a uint32 label or timestep and
+                  the 64 bits blocks of the form*/
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Write a form as a grid, its last row first, followed by its label,
+ * the layout of formFile
+ *
+ * @param os : output
+ * @param form : form of width x height cells
+ * @param width : width of the grid
+ * @param height : height of the grid
+ * @param formLabel : number written under the grid
+ */
+/* -----------------------------------------------------------*/
+void writeFormGrid(
+    std::ostream &os,
+    const Form &form,
+    unsigned int width,
+    unsigned int height,
+    unsigned int formLabel);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Buffered writer of formFile and graphFile on a background thread
+ * The forms are queued and written by the thread through buffered streams,
+ * so that adding a form never waits for the disk. graphFile holds every form
+ * of the graph timestep after timestep, formFile the final forms.
+ *
+ * In the binary format, each file starts with the magic "MCELLFF" or
+ * "MCELLGF" on 8 bytes then the uint32 width, height and number of blocks
+ * of a form, in the byte order of the machine.
+ */
+/* -----------------------------------------------------------*/
+class FormWriter
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Open the files and start the writing thread
+   *
+   * @param formFileName : file of the final forms
+   * @param graphFileName : file of the forms of the graph
+   * @param width : width of the grid
+   * @param height : height of the grid
+   * @param format : layout of the files
+   */
+  /* -----------------------------------------------------------*/
+  FormWriter(
+      const std::string &formFileName,
+      const std::string &graphFileName,
+      unsigned int width,
+      unsigned int height,
+      FormFileFormat format);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Write what is left and close the files, see close
+   */
+  /* -----------------------------------------------------------*/
+  ~FormWriter();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Add a form of the current timestep to graphFile
+   */
+  /* -----------------------------------------------------------*/
+  void addForm(const Form &form);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief End the current timestep of graphFile
+   */
+  /* -----------------------------------------------------------*/
+  void endTimestep();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Add a final form to formFile
+   *
+   * @param form : final form
+   * @param formLabel : number of the form in formFile
+   */
+  /* -----------------------------------------------------------*/
+  void addFinalForm(
+      const Form &form,
+      unsigned int formLabel);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Wait for every form added to be written then close the files
+   *
+   * @return false if a file could not be written
+   */
+  /* -----------------------------------------------------------*/
+  bool close();
+
+private:
+  enum RecordKind
+  {
+    GRAPH_FORM,
+    END_TIMESTEP,
+    FINAL_FORM
+  };
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Form waiting to be written
+   */
+  /* -----------------------------------------------------------*/
+  struct Record
+  {
+    RecordKind kind;
+    unsigned int label; /*!< label of a final form*/
+    Form form;
+  };
+
+  void push(
+      RecordKind kind,
+      unsigned int label,
+      const Form &form);
+  void run();
+  void write(const Record &record);
+  void writeHeader(
+      std::ostream &os,
+      const char *magic);
+  void writeBinary(
+      std::ostream &os,
+      boost::uint32_t label,
+      const Form &form);
+
+  unsigned int _width;
+  unsigned int _height;
+  FormFileFormat _format;
+  std::vector<char> _formBuffer; /*!< buffers of the streams*/
+  std::vector<char> _graphBuffer;
+  std::ofstream _formFile;
+  std::ofstream _graphFile;
+  unsigned int _timestep; /*!< timestep of the graph forms written*/
+
+  boost::mutex _mutex;
+  boost::condition_variable _ready;
+  std::vector<Record> _pending; /*!< records added, not yet taken*/
+  bool _closing;
+  bool _closed;
+  boost::thread _thread;
+};
+
+#endif
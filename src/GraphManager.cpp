@@ -1,9 +1,32 @@
 #include <numeric>
 
 #include "GraphManager.hpp"
+#include "Instrumentation.hpp"
+#include "ReactionKernel.hpp"
+#include "Trace.hpp"
 
-GraphManager::GraphManager()
-{}
+GraphManager::GraphManager() :
+  _lazyEnv(false),
+  _healthy(false),
+  _initEne(0),
+  _initOxy(0),
+  _initGlu(0),
+  _initLac(0),
+  _hInGlu(0),
+  _hInOxy(0),
+  _hOutEneOxy(0),
+  _hOutEneNoOxy(0),
+  _hOutLac(0),
+  _hLacMitose(0),
+  _cInGlu(0),
+  _cInOxy(0),
+  _cOutEne(0),
+  _cOutLac(0),
+  _cLacMitose(0),
+  _eneMitose(0)
+{
+  precomputeReactions();
+}
 
 GraphManager::GraphManager (
       std::vector<int> dim,
@@ -23,8 +46,12 @@ GraphManager::GraphManager (
       double cOutEne,
       double cOutLac,
       double cLacMitose,
-      double eneMitose):
+      double eneMitose,
+      ConcentrationPrecision precision):
   _gForm(g),
+  _concentrations(dim[0] * dim[1] * dim[2], precision),
+  _lazyEnv(false),
+  _healthy(false),
   _initEne(initEne),
   _initOxy(initOxy),
   _initGlu(initGlu),
@@ -42,6 +69,7 @@ GraphManager::GraphManager (
   _cLacMitose(cLacMitose),
   _eneMitose(eneMitose)
 {
+  precomputeReactions();
 }
 
 GraphManager::~GraphManager()
@@ -52,7 +80,7 @@ void GraphManager::healthy_reaction(
     std::vector<double> &oxygen,
     std::vector<double> &glucose,
     std::vector<double> &lactate,
-    int pos)
+    int pos) const
 {
   while(glucose[pos] >= _hInGlu && energy[pos] < _eneMitose)
   {
@@ -73,7 +101,7 @@ void GraphManager::cancerous_reaction(
     std::vector<double> &oxygen,
     std::vector<double> &glucose,
     std::vector<double> &lactate,
-    int pos)
+    int pos) const
 {
   while(glucose[pos] >= _cInGlu && energy[pos] < _eneMitose)
   {
@@ -92,7 +120,7 @@ void GraphManager::init_ressource(
     std::vector<double> &oxygen,
     std::vector<double> &glucose,
     std::vector<double> &lactate,
-    const boost::dynamic_bitset<> &form)
+    const graphVertex &form) const
 {
   int pos = form.find_first();
   // reset the env concentration to 0
@@ -114,10 +142,10 @@ void GraphManager::init_ressource(
 bool GraphManager::canMitose(
     int pos,
     char dir,
-    std::vector<int> dim,
-    std::vector<double> &energy,
-    std::vector<double> &lactate,
-    bool healthy)
+    const std::vector<int> &dim,
+    const std::vector<double> &energy,
+    const std::vector<double> &lactate,
+    bool healthy) const
 {
   double lacMitose;
   if (healthy)
@@ -134,51 +162,183 @@ bool GraphManager::canMitose(
   }
 }
 
-Graph GraphManager::getGForm() const
+void GraphManager::react(
+    const graphVertex &form,
+    bool healthy,
+    std::vector<double> &energy,
+    std::vector<double> &oxygen,
+    std::vector<double> &glucose,
+    std::vector<double> &lactate) const
+{
+  energy.resize(form.size());
+  oxygen.resize(form.size());
+  glucose.resize(form.size());
+  lactate.resize(form.size());
+
+  // every cell starts with the initial concentrations, so every cell ends
+  // with the reacted cell computed once by precomputeReactions
+  const double *cell = getReactedCell(healthy);
+  energy.assign(form.size(), 0.0);
+  oxygen.assign(form.size(), 0.0);
+  glucose.assign(form.size(), 0.0);
+  lactate.assign(form.size(), 0.0);
+  for (graphVertex::size_type pos = form.find_first();
+       pos != graphVertex::npos; pos = form.find_next(pos))
+  {
+    energy[pos] = cell[ENERGY];
+    oxygen[pos] = cell[OXYGEN];
+    glucose[pos] = cell[GLUCOSE];
+    lactate[pos] = cell[LACTATE];
+  }
+}
+
+const double* GraphManager::getReactedCell(bool healthy) const
+{
+  return _reactedCell[healthy ? 1 : 0];
+}
+
+void GraphManager::precomputeReactions()
+{
+  for (unsigned int healthy = 0; healthy < 2; healthy++)
+  {
+    double *cell = _reactedCell[healthy];
+    cell[ENERGY] = _initEne;
+    cell[OXYGEN] = _initOxy;
+    cell[GLUCOSE] = _initGlu;
+    cell[LACTATE] = _initLac;
+    if (healthy)
+    {
+      ReactionKernel(_hInGlu, _hInOxy, _hOutEneOxy, _hOutEneNoOxy, _hOutLac,
+          false, _eneMitose).react(&cell[ENERGY], &cell[OXYGEN],
+          &cell[GLUCOSE], &cell[LACTATE], 1);
+    } else {
+      ReactionKernel(_cInGlu, _cInOxy, _cOutEne, _cOutEne, _cOutLac,
+          true, _eneMitose).react(&cell[ENERGY], &cell[OXYGEN],
+          &cell[GLUCOSE], &cell[LACTATE], 1);
+    }
+  }
+}
+
+void GraphManager::setLazyEnv(
+    bool healthy,
+    std::size_t cacheSize)
+{
+  _lazyEnv = true;
+  _healthy = healthy;
+  _envCache.setCapacity(cacheSize);
+}
+
+bool GraphManager::hasLazyEnv() const
+{
+  return _lazyEnv;
+}
+
+const Graph& GraphManager::getGForm() const
 {
   return _gForm;
 }
 
+const graphVertex& GraphManager::getForm(Vertex v) const
+{
+  return _gForm[v];
+}
+
+const ConcentrationArena& GraphManager::getConcentrations() const
+{
+  return _concentrations;
+}
+
+void GraphManager::reserveForms(std::size_t nbForms)
+{
+  _concentrations.reserve(nbForms);
+}
+
 Vertex GraphManager::add_vertexToGForm(
-    boost::dynamic_bitset<> form,
+    graphVertex form,
     const std::vector<double> &energy,
     const std::vector<double> &oxygen,
     const std::vector<double> &glucose,
-    const std::vector<double> &lactate)
+    const std::vector<double> &lactate,
+    Vertex parent)
 {
-  boost::add_vertex(energy, _gEnergy);
-  boost::add_vertex(oxygen, _gOxygen);
-  boost::add_vertex(glucose, _gGlucose);
-  boost::add_vertex(lactate, _gLactate);
+  if (!_lazyEnv)
+    _concentrations.append(&energy[0], &oxygen[0], &glucose[0], &lactate[0]);
+  _parents.push_back(parent);
   return boost::add_vertex(form, _gForm);
 }
 
-void GraphManager::add_edgeToGForm(
-    Vertex u,
+void GraphManager::clearForms()
+{
+  _gForm.clear();
+  _formIndex.clear();
+  _concentrations.clear();
+  _parents.clear();
+  _envCache.clear();
+}
+
+Vertex GraphManager::getParent(Vertex v) const
+{
+  return _parents[v];
+}
+
+void GraphManager::indexForm(
+    const graphVertex &key,
     Vertex v,
-    const graphEdge& p)
+    unsigned int symmetry)
 {
-  add_edge(u, v, p, _gForm);
+  IndexedForm &form = _formIndex[key];
+  form.vertex = v;
+  form.symmetry = symmetry;
 }
 
-VectorGraph& GraphManager::getGEnergy()
+bool GraphManager::findForm(
+    const graphVertex &key,
+    Vertex &v,
+    unsigned int &symmetry) const
 {
-  return _gEnergy;
+  TraceScope scope(TRACE_FIND_FORM, _formIndex.size());
+  FormIndex::const_iterator it = _formIndex.find(key);
+  if (it == _formIndex.end())
+  {
+    return false;
+  }
+  v = it->second.vertex;
+  symmetry = it->second.symmetry;
+  return true;
 }
 
-VectorGraph& GraphManager::getGOxygen()
+void GraphManager::add_edgeToGForm(
+    Vertex u,
+    Vertex v,
+    const graphEdge& p)
 {
-  return _gOxygen;
+  add_edge(u, v, p, _gForm);
 }
 
-VectorGraph& GraphManager::getGGlucose()
+void GraphManager::loadEnvGraphs(
+    const VectorGraph &gEnergy,
+    const VectorGraph &gOxygen,
+    const VectorGraph &gGlucose,
+    const VectorGraph &gLactate)
 {
-  return _gGlucose;
+  std::size_t nbForms = boost::num_vertices(gEnergy);
+  std::size_t maxSize = nbForms ? gEnergy[0].size() : 0;
+  _concentrations = ConcentrationArena(maxSize);
+  _concentrations.reserve(nbForms);
+  for (std::size_t v = 0; v < nbForms; v++)
+    _concentrations.append(&gEnergy[v][0], &gOxygen[v][0],
+        &gGlucose[v][0], &gLactate[v][0]);
 }
 
-VectorGraph& GraphManager::getGLactate()
+std::vector<double> GraphManager::getParameters() const
 {
-  return _gLactate;
+  double parameters[] = {
+    _initEne, _initOxy, _initGlu, _initLac,
+    _hInGlu, _hInOxy, _hOutEneOxy, _hOutEneNoOxy, _hOutLac, _hLacMitose,
+    _cInGlu, _cInOxy, _cOutEne, _cOutLac, _cLacMitose,
+    _eneMitose};
+  return std::vector<double>(parameters,
+      parameters + sizeof(parameters) / sizeof(parameters[0]));
 }
 
 int GraphManager::getMaxNbrOfForm() const
@@ -188,32 +348,53 @@ int GraphManager::getMaxNbrOfForm() const
 
 void GraphManager::getFormFromGraph(
     int index,
-    const Graph &g,
-    boost::dynamic_bitset<> &form,
+    graphVertex &form,
     std::vector<double> &energy,
     std::vector<double> &oxygen,
     std::vector<double> &glucose,
-    std::vector<double> &lactate)
+    std::vector<double> &lactate) const
 {
-  // Get the new form
-  pair< vertex_iter, vertex_iter > vertexPair = vertices(_gForm);
-  vertexPair.first += index;
-  form = _gForm[*vertexPair.first];
-
-  vertexPair = vertices(_gEnergy);
-  vertexPair.first += index;
-  energy = _gEnergy[*vertexPair.first];
+  // vertices are stored in vectors, the index of a form is its vertex
+  form = _gForm[index];
+  if (!_lazyEnv)
+  {
+    _concentrations.get(ENERGY, index, energy);
+    _concentrations.get(OXYGEN, index, oxygen);
+    _concentrations.get(GLUCOSE, index, glucose);
+    _concentrations.get(LACTATE, index, lactate);
+    return;
+  }
 
-  vertexPair = vertices(_gOxygen);
-  vertexPair.first += index;
-  oxygen = _gOxygen[*vertexPair.first];
+  const FormEnv *cached = _envCache.find(index);
+  if (cached)
+  {
+    Instrumentation::add(Instrumentation::ENV_CACHE_HITS);
+    energy = cached->energy;
+    oxygen = cached->oxygen;
+    glucose = cached->glucose;
+    lactate = cached->lactate;
+    return;
+  }
 
-  vertexPair = vertices(_gGlucose);
-  vertexPair.first += index;
-  glucose = _gGlucose[*vertexPair.first];
+  Instrumentation::add(Instrumentation::ENV_RECOMPUTATIONS);
+  Vertex parent = _parents[index];
+  if (parent == NO_PARENT)
+  {
+    energy.assign(form.size(), _initEne);
+    oxygen.assign(form.size(), _initOxy);
+    glucose.assign(form.size(), _initGlu);
+    lactate.assign(form.size(), _initLac);
+  } else {
+    react(_gForm[parent], _healthy, energy, oxygen, glucose, lactate);
+  }
 
-  vertexPair = vertices(_gLactate);
-  vertexPair.first += index;
-  lactate = _gLactate[*vertexPair.first];
+  if (_envCache.getCapacity())
+  {
+    FormEnv env;
+    env.energy = energy;
+    env.oxygen = oxygen;
+    env.glucose = glucose;
+    env.lactate = lactate;
+    _envCache.insert(index, env);
+  }
 }
-
@@ -11,10 +11,18 @@
 /* std include */
 #include <vector>
 
+/* boost include */
+#include <boost/serialization/version.hpp>
+#include <boost/unordered_map.hpp>
+
 /* project include */
+#include "ConcentrationArena.hpp"
+#include "EnvCache.hpp"
 #include "environment.h"
+#include "FormSource.hpp"
 
-// Defining the graph vertices
+// Defining the graph vertices, the graphs of the env are only used to load
+// archives written before ConcentrationArena
 typedef std::vector<double> vectorGraphVertex; // form which can be either a
                                              // starting form or the reached
                                              // form after mitose
@@ -25,12 +33,25 @@ typedef boost::adjacency_list< boost::vecS, boost::vecS, boost::directedS,
 typedef boost::graph_traits< VectorGraph >::vertex_iterator vectorVertex_iter;
 typedef VectorGraph::vertex_descriptor VectorVertex;
 
+// Form of the graph found by its canonical key
+struct IndexedForm
+{
+  Vertex vertex; // vertex of the form in the form graph
+  unsigned int symmetry; // Symmetry of the form which is its key
+};
+
+// Hash index from the canonical key of a form to the form of the graph
+typedef boost::unordered_map< graphVertex, IndexedForm > FormIndex;
+
+// Parent of a form which is not reached by a mitosis, such as the root
+const Vertex NO_PARENT = static_cast<Vertex>(-1);
+
 /* -----------------------------------------------------------*/
 /** 
  * @brief This class is used for managing graphs
  */
 /* -----------------------------------------------------------*/
-class GraphManager
+class GraphManager : public FormSource
 {
 public:
   /* -----------------------------------------------------------*/
@@ -62,6 +83,7 @@ public:
    * @param cOutLac : cancerous cell production of lactate when doing a cancerous reaction
    * @param cLacMitose : cancerous cell max threshold of lactate for allowing a mitosis
    * @param eneMitose : energy needed for allowing a mitosis
+   * @param precision : storage of the env saved with each form
    */
   /* -----------------------------------------------------------*/
   GraphManager (
@@ -70,7 +92,8 @@ public:
       double initEne, double initOxy, double initGlu, double initLac,
       double hInGlu, double hInOxy, double hOutEneOxy, double hOutEneNoOxy, double hOutLac, double hLacMitose,
       double cInGlu, double cInOxy, double cOutEne, double cOutLac, double cLacMitose,
-      double eneMitose);
+      double eneMitose,
+      ConcentrationPrecision precision = DOUBLE_PRECISION);
   virtual ~GraphManager ();
 
   /* -----------------------------------------------------------*/
@@ -92,7 +115,7 @@ public:
       std::vector<double> &oxygen,
       std::vector<double> &glucose,
       std::vector<double> &lactate,
-      int pos);
+      int pos) const;
 
   /* -----------------------------------------------------------*/
   /** 
@@ -113,7 +136,7 @@ public:
       std::vector<double> &oxygen,
       std::vector<double> &glucose,
       std::vector<double> &lactate,
-      int pos);
+      int pos) const;
 
   /* -----------------------------------------------------------*/
   /** 
@@ -133,7 +156,7 @@ public:
       std::vector<double> &oxygen,
       std::vector<double> &glucose,
       std::vector<double> &lactate,
-      const boost::dynamic_bitset<> &form);
+      const graphVertex &form) const;
 
   /* -----------------------------------------------------------*/
   /** 
@@ -155,19 +178,100 @@ public:
   bool canMitose(
       int pos,
       char dir,
-      std::vector<int> dim,
+      const std::vector<int> &dim,
+      const std::vector<double> &energy,
+      const std::vector<double> &lactate,
+      bool healthy) const;
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Compute the env of a form after its reactions
+   * 
+   * @param[in] form : form of cells
+   * @param[in] healthy : true if healthy, false if cancerous
+   * @param[out] energy  : energy concentration of the env
+   * @param[out] oxygen  : oxygen concentration of the env
+   * @param[out] glucose : glucose concentration of the env
+   * @param[out] lactate : lactate concentration of the env
+   * init_ressource then a healthy_reaction or cancerous_reaction for each
+   * cell of the form, this is the env saved with the children of the form.
+   * As init_ressource gives the same concentrations to every cell, the
+   * reactions are only done once, by the constructor, and copied in the
+   * cells of the form.
+   */
+  /* -----------------------------------------------------------*/
+  void react(
+      const graphVertex &form,
+      bool healthy,
       std::vector<double> &energy,
-      std::vector<double> &lactate,
-      bool healthy);
+      std::vector<double> &oxygen,
+      std::vector<double> &glucose,
+      std::vector<double> &lactate) const;
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Concentrations of any cell of a form after its reactions
+   * 
+   * @param[in] healthy : true if healthy, false if cancerous
+   * 
+   * @return the NB_CONCENTRATIONS values indexed by Concentration, the env
+   * given by react in each cell of the form
+   */
+  /* -----------------------------------------------------------*/
+  const double* getReactedCell(bool healthy) const;
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Stop saving the env of the forms, recompute it when asked
+   * 
+   * @param[in] healthy : true if healthy, false if cancerous
+   * @param[in] cacheSize : number of recomputed env kept, 0 keeps none
+   * The env of a form is the env of its parent after react, only the parent
+   * is saved with each form. It must be called before adding forms.
+   */
+  /* -----------------------------------------------------------*/
+  void setLazyEnv(
+      bool healthy,
+      std::size_t cacheSize);
+  bool hasLazyEnv() const;
 
   /* -----------------------------------------------------------*/
   /** 
    * @brief Getter of the form graph
    * 
-   * @return the form graph
+   * @return the form graph, read only
+   * The reference is invalidated by add_vertexToGForm and add_edgeToGForm
+   */
+  /* -----------------------------------------------------------*/
+  const Graph& getGForm() const;
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Read only access to a form
+   * 
+   * @param[in] v : vertex of the form
+   * 
+   * @return the form, without copy
+   * The reference is invalidated by add_vertexToGForm
+   */
+  /* -----------------------------------------------------------*/
+  const graphVertex& getForm(Vertex v) const;
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Read only access to the env saved with the forms
+   * 
+   * @return the arena, the env of vertex v being its form v
    */
   /* -----------------------------------------------------------*/
-  Graph getGForm() const;
+  const ConcentrationArena& getConcentrations() const;
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Reserve room for nbForms forms in the arena of the env
+   */
+  /* -----------------------------------------------------------*/
+  void reserveForms(std::size_t nbForms);
 
   /* -----------------------------------------------------------*/
   /** 
@@ -178,16 +282,69 @@ public:
    * @param[in] oxygen  : oxygen concentration of the env to be saved
    * @param[in] glucose : glucose concentration of the env to be saved
    * @param[in] lactate : lactate concentration of the env to be saved
+   * @param[in] parent : form whose mitosis reached this one, NO_PARENT for
+   * the root, its env being the initial concentrations in every cell
    * 
    * @return the vertex created
+   * The env is not used with setLazyEnv.
    */
   /* -----------------------------------------------------------*/
   Vertex add_vertexToGForm(
-      boost::dynamic_bitset<> form,
+      graphVertex form,
       const std::vector<double> &energy,
       const std::vector<double> &oxygen,
       const std::vector<double> &glucose,
-      const std::vector<double> &lactate);
+      const std::vector<double> &lactate,
+      Vertex parent = NO_PARENT);
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Remove every form and edge, the thresholds being kept
+   */
+  /* -----------------------------------------------------------*/
+  void clearForms();
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Getter of the parent of a form
+   * 
+   * @return the vertex given to add_vertexToGForm
+   */
+  /* -----------------------------------------------------------*/
+  Vertex getParent(Vertex v) const;
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Record the canonical key of a form already added to the graph
+   * 
+   * @param[in] key : canonical key of the form, see Environment::canonicalForm
+   * @param[in] v : vertex of the form in the form graph
+   * @param[in] symmetry : Symmetry of the form which is the key
+   */
+  /* -----------------------------------------------------------*/
+  void indexForm(
+      const graphVertex &key,
+      Vertex v,
+      unsigned int symmetry);
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Look up a form by its canonical key
+   * 
+   * @param[in] key : canonical key of the form, see Environment::canonicalForm
+   * @param[out] v : vertex of the form in the form graph if found
+   * @param[out] symmetry : Symmetry of that form which is the key, if found
+   * 
+   * @return true if an equivalent form is already in the graph
+   * The lookup costs one hash computation, whatever the number of forms.
+   * The index is not serialized, it has to be rebuilt with indexForm after
+   * loading a GraphManager.
+   */
+  /* -----------------------------------------------------------*/
+  bool findForm(
+      const graphVertex &key,
+      Vertex &v,
+      unsigned int &symmetry) const;
 
   /* -----------------------------------------------------------*/
   /** 
@@ -206,15 +363,13 @@ public:
 
   /* -----------------------------------------------------------*/
   /** 
-   * @brief Getter of the energy graph
+   * @brief Getter of the thresholds
    * 
-   * @return the energy graph
+   * @return the thresholds in the order of the constructor, from initEne to
+   * eneMitose
    */
   /* -----------------------------------------------------------*/
-  VectorGraph& getGEnergy();
-  VectorGraph& getGOxygen();
-  VectorGraph& getGGlucose();
-  VectorGraph& getGLactate();
+  std::vector<double> getParameters() const;
 
   /* -----------------------------------------------------------*/
   /** 
@@ -230,31 +385,47 @@ public:
    * @brief Get a specific form of the form graph and the corresponding env
    * 
    * @param[in] index : index of the form
-   * @param[in] g : form graph
    * @param[out] form : corresponding form at index
    * @param[out] energy : corresponding energy env at index
    * @param[out] oxygen : corresponding oxygen env at index
    * @param[out] glucose : corresponding glucose env at index
    * @param[out] lactate : corresponding lactate env at index
+   * With setLazyEnv the env is recomputed, or taken from the cache which
+   * makes this function unsafe to call from several threads.
    */
   /* -----------------------------------------------------------*/
   void getFormFromGraph(
       int index,
-      const Graph &g,
-      boost::dynamic_bitset<> &form,
+      graphVertex &form,
       std::vector<double> &energy,
       std::vector<double> &oxygen,
       std::vector<double> &glucose,
-      std::vector<double> &lactate);
+      std::vector<double> &lactate) const;
 
   template<class Archive>
     void serialize(Archive & ar, const unsigned int version)
     {
       ar & _gForm;
-      ar & _gEnergy;
-      ar & _gOxygen;
-      ar & _gGlucose;
-      ar & _gLactate;
+      if (version == 0)
+      {
+        // env saved in graphs before the arena, only read
+        VectorGraph gEnergy, gOxygen, gGlucose, gLactate;
+        ar & gEnergy;
+        ar & gOxygen;
+        ar & gGlucose;
+        ar & gLactate;
+        loadEnvGraphs(gEnergy, gOxygen, gGlucose, gLactate);
+      } else {
+        ar & _concentrations;
+      }
+      if (version >= 2)
+      {
+        ar & _parents;
+        ar & _lazyEnv;
+        ar & _healthy;
+      } else {
+        _parents.assign(boost::num_vertices(_gForm), NO_PARENT);
+      }
       ar & _initEne;
       ar & _initOxy;
       ar & _initGlu;
@@ -271,15 +442,36 @@ public:
       ar & _cOutLac;
       ar & _cLacMitose;
       ar & _eneMitose;
+      precomputeReactions();
     }
 private:
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Compute the healthy and cancerous reacted cell from the initial
+   * concentrations, to be called whenever the thresholds change
+   */
+  /* -----------------------------------------------------------*/
+  void precomputeReactions();
+
+  /* -----------------------------------------------------------*/
+  /** 
+   * @brief Fill the arena with the env graphs of an old archive
+   */
+  /* -----------------------------------------------------------*/
+  void loadEnvGraphs(
+      const VectorGraph &gEnergy,
+      const VectorGraph &gOxygen,
+      const VectorGraph &gGlucose,
+      const VectorGraph &gLactate);
+
   /* data */
   Graph _gForm; /*!< form graph*/
-  /* env graphs */
-  VectorGraph _gEnergy;
-  VectorGraph _gOxygen;
-  VectorGraph _gGlucose;
-  VectorGraph _gLactate;
+  FormIndex _formIndex; /*!< canonical key to vertex of the form graph*/
+  ConcentrationArena _concentrations; /*!< env saved with each form*/
+  std::vector<Vertex> _parents; /*!< parent of each form*/
+  bool _lazyEnv; /*!< env recomputed instead of saved*/
+  bool _healthy; /*!< type of the cells, for the recomputed env*/
+  mutable EnvCache _envCache; /*!< recomputed env*/
 
   /* threshold see constructor */
   double _initEne;
@@ -298,6 +490,14 @@ private:
   double _cOutLac;
   double _cLacMitose;
   double _eneMitose;
+
+  /* concentrations of a cell after its reactions, cancerous then healthy,
+   * indexed by Concentration */
+  double _reactedCell[2][NB_CONCENTRATIONS];
 };
 
+// version 1 : env in a ConcentrationArena
+// version 2 : parent of each form and lazy env
+BOOST_CLASS_VERSION(GraphManager, 2)
+
 #endif
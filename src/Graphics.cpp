@@ -14,6 +14,10 @@
 #include <cstdlib>
 #include <algorithm>
 
+// Forms loaded ahead on each side of the form under view, the Up and Down
+// keys moving by 10 forms
+static const int PREFETCH_WINDOW = 10;
+
 /* -----------------------------------------------------------*/
 /** 
  * @brief Callback used to react to keypress in the vtk windows
@@ -65,10 +69,10 @@ void KeypressCallbackFunction (
 }
 
 GraphViewer::GraphViewer (
-    GraphManager &gm,
+    const FormSource &forms,
     std::vector<double> bgColor,
     std::vector<int> dim) :
-  _gm(gm),
+  _forms(forms, PREFETCH_WINDOW),
   _bgColor(bgColor),
   _dim(dim),
   _renderer(vtkSmartPointer<vtkRenderer>::New()),
@@ -94,12 +98,7 @@ GraphViewer::GraphViewer (
   _concGlyph3D(vtkSmartPointer<vtkGlyph3D>::New()),
   _concMapper(vtkSmartPointer<vtkPolyDataMapper>::New()),
   _concActor(vtkSmartPointer<vtkActor>::New()),
-  _formIndex(0),
-  _form(),
-  _EForm(),
-  _OForm(),
-  _GForm(),
-  _LForm()
+  _formIndex(0)
 {
   // Set the object flow for the vtk window
   _renderWindow->AddRenderer(_renderer);
@@ -222,11 +221,11 @@ int GraphViewer::getFormIndex() const
 void GraphViewer::setFormIndex(int newFormIndex)
 {
   // Count the total number of form in the graph
-  int maxForm = _gm.getMaxNbrOfForm();
+  int maxForm = _forms.getMaxNbrOfForm();
   // Count the difference from the current form index and the new form index
   newFormIndex = std::min(std::max(0, newFormIndex), maxForm-1);
   _formIndex = newFormIndex;
-  _gm.getFormFromGraph(newFormIndex, _gm.getGForm(), _form, _EForm, _OForm, _GForm, _LForm);
+  _page = _forms.getForm(newFormIndex);
 
   drawForm();
 }
@@ -246,6 +245,24 @@ void GraphViewer::resizeCubes(int size)
   _concColors->SetNumberOfComponents(3);
   // set number of colors from the maximum number of cells * number of graph
   _concColors->SetNumberOfTuples(size*4);
+
+  int x, y, z;
+  unsigned char green[3] = {0, 255, 0};
+  for (vtkIdType i = 0; i < size; ++i) {
+    // the cubes of the form are all green
+    _cubeColors->SetTupleValue(i, green);
+    // each concentration is a grid of cubes above the form
+    for (int c = 0; c < 4; c++) {
+      getXYZ(i+(c+2)*size, x, y, z);
+      _concPoints->SetPoint(i+c*size, x, y, z);
+    }
+  }
+  _cubeColors->Modified();
+  _concPoints->Modified();
+
+  // nothing is drawn yet
+  _cubeCells.assign(size, -1);
+  _drawnPage.reset();
 }
 
 void GraphViewer::getXYZ(
@@ -276,7 +293,7 @@ void OutputPoints(vtkSmartPointer<vtkPoints> points)
     }
 }
 
-void printColor(const std::vector<unsigned char> &color)
+void printColor(const unsigned char color[3])
 {
   std::cout << "color[r, g, b] : " << std::dec << (int)color[0] << " "
                                    << std::dec << (int)color[1] << " "
@@ -286,9 +303,8 @@ void printColor(const std::vector<unsigned char> &color)
 void GraphViewer::linearColorGradient(
     const std::vector<double> &compConcentration,
     int pos,
-    std::vector<unsigned char> &color)
+    unsigned char color[3])
 {
-  assert(color.size() == 3);
   //std::cout << "cc : " << compConcentration.size() << std::endl;
   //std::cout << "pos" << pos << std::endl;
   assert(compConcentration.size() > pos);
@@ -306,75 +322,58 @@ void GraphViewer::linearColorGradient(
 
 void GraphViewer::drawForm()
 {
-   //Check the number of cubes, resize if different
-  if (_form.count() != _cubePoints->GetNumberOfPoints())
+  // the cubes are allocated once for the grid
+  const graphVertex &form = _page->form;
+  int size = form.size();
+  if (size != _cubePoints->GetNumberOfPoints())
   {
-    resizeCubes(_form.size());
+    resizeCubes(size);
   }
-  // pos is used for the index of the current cube
-  int pos = _form.find_first(), firstPos = 0;
-  int x, y, z;
 
-  std::cout << "New Form at index : " << _formIndex << std::endl;
-  int maxNbrPoints = _cubePoints->GetNumberOfPoints();
-  // set position and color for all cubes to be drawn
-  for (vtkIdType i = 0; i < maxNbrPoints; ++i) {
-    //std::cout << "find 1 at " << pos << std::endl;
-    
-    std::vector<unsigned char> color(3, 0);
-    color[0] = 0;
-    color[1] = 255;
-    color[2] = 0;
-    
-    // if there is a cell
-    if (pos != -1)
+  // cube i is drawn at the i-th cell, the cubes left over at the first cell,
+  // and only the cubes which move are updated
+  graphVertex::size_type pos = form.find_first();
+  int firstPos = pos == graphVertex::npos ? 0 : pos;
+  bool cubesMoved = false;
+  int x, y, z;
+  for (vtkIdType i = 0; i < size; ++i) {
+    int cell = pos == graphVertex::npos ? firstPos : pos;
+    if (cell != _cubeCells[i])
     {
-      // save first position
-      if (i == 0) firstPos = pos;
-      // the the 3D coordinate from the index pos
-      getXYZ(pos, x, y, z);
-      //printColor(color);
-    } else {
-      // cubes where there are no cells are all drawn at the first position
-      getXYZ(firstPos, x, y, z);
+      getXYZ(cell, x, y, z);
+      _cubePoints->SetPoint(i, x, y, z);
+      _cubeCells[i] = cell;
+      cubesMoved = true;
     }
-    // set the cube coordinates
-    _cubePoints->SetPoint(i, x, y, z);
-    // set the cube color
-    _cubeColors->SetTupleValue(i, &color[0]);
-    // find next cell position
-    pos = _form.find_next(pos);
-
-    // get the linear gradient color from concentration at position i
-    linearColorGradient(_EForm, i, color);
-    // get 3D coordinates from index
-    getXYZ(i+2*maxNbrPoints, x, y, z);
-    // set cube coordinate
-    _concPoints->SetPoint(i, x, y, z);
-    // set the cube colors
-    _concColors->SetTupleValue(i, &color[0]);
-
-    linearColorGradient(_OForm, i, color);
-    getXYZ(i+3*maxNbrPoints, x, y, z);
-    _concPoints->SetPoint(i+1*maxNbrPoints, x, y, z);
-    _concColors->SetTupleValue(i+1*maxNbrPoints, &color[0]);
-
-    linearColorGradient(_GForm, i, color);
-    getXYZ(i+4*maxNbrPoints, x, y, z);
-    _concPoints->SetPoint(i+2*maxNbrPoints, x, y, z);
-    _concColors->SetTupleValue(i+2*maxNbrPoints, &color[0]);
-
-    linearColorGradient(_LForm, i, color);
-    getXYZ(i+5*maxNbrPoints, x, y, z);
-    _concPoints->SetPoint(i+3*maxNbrPoints, x, y, z);
-    _concColors->SetTupleValue(i+3*maxNbrPoints, &color[0]);
+    if (pos != graphVertex::npos) pos = form.find_next(pos);
   }
-  //OutputPoints(_cubePoints);
-  // update vtk flow
-  _cubeGlyph3D->Update();
-  _concGlyph3D->Update();
-  _renderWindow->Render();
-  //std::cout << _cubePoints->GetNumberOfPoints() << std::endl;
-  //std::cout << _cubeColors->GetNumberOfPoints() << std::endl;
+  // vtk only draws again the arrays marked as modified
+  if (cubesMoved) _cubePoints->Modified();
+
+  // recolor the concentrations which changed since the form drawn
+  const std::vector<double> *concentrations[4] = {
+    &_page->energy, &_page->oxygen, &_page->glucose, &_page->lactate};
+  const std::vector<double> *drawn[4] = {NULL, NULL, NULL, NULL};
+  if (_drawnPage)
+  {
+    drawn[0] = &_drawnPage->energy;
+    drawn[1] = &_drawnPage->oxygen;
+    drawn[2] = &_drawnPage->glucose;
+    drawn[3] = &_drawnPage->lactate;
+  }
+  bool recolored = false;
+  unsigned char color[3];
+  for (int c = 0; c < 4; c++) {
+    for (vtkIdType i = 0; i < size; ++i) {
+      if (drawn[c] && (*drawn[c])[i] == (*concentrations[c])[i]) continue;
+      linearColorGradient(*concentrations[c], i, color);
+      _concColors->SetTupleValue(i+c*size, color);
+      recolored = true;
+    }
+  }
+  if (recolored) _concColors->Modified();
+  _drawnPage = _page;
 
+  // the glyphs are computed again by the render, if their input changed
+  _renderWindow->Render();
 }
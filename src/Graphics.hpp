@@ -29,11 +29,6 @@
 #include <vtkPointData.h>
 #include <vtkFloatArray.h>
 
-/**
- * Boost include
- */
-#include <boost/dynamic_bitset.hpp>
-
 /**
  * Standard library include
  */
@@ -44,7 +39,8 @@
  * Project include
  */
 #include "environment.h"
-#include "GraphManager.hpp"
+#include "FormPager.hpp"
+#include "FormSource.hpp"
 
 /* -----------------------------------------------------------*/
 /** 
@@ -58,14 +54,14 @@ public:
   /** 
    * @brief Constructor
    * 
-   * @param g : Graph object to view, contains Boost::dynamic_bitset<> of forms
-   * @param verticesPerTimestep : number of forms for each level of the graph
+   * @param forms : forms to view, from a GraphManager or a ResultStore, only
+   * the form under view and its neighbours being loaded
    * @param bgColor : background color for the vtk windows
    * @param dim : 3D space size
    */
   /* -----------------------------------------------------------*/
   GraphViewer (
-      GraphManager &gm,
+      const FormSource &forms,
       std::vector<double> bgColor,
       std::vector<int> dim);
   /* -----------------------------------------------------------*/
@@ -135,9 +131,11 @@ private:
       int &z);
   /* -----------------------------------------------------------*/
   /** 
-   * @brief Resize the number of cubes to be drawn by vtk
+   * @brief Allocate the cubes to be drawn by vtk for a grid of size cells
+   * Places the concentration cubes, which never move, and colors the cubes
+   * of the form, which never change color.
    * 
-   * @param[in] size : new number of cubes to be drawn
+   * @param[in] size : number of cells of the grid
    */
   /* -----------------------------------------------------------*/
   void resizeCubes(int size);
@@ -149,13 +147,13 @@ private:
    * 
    * @param[in] compConcentration : concentration environment
    * @param[in] pos : position of interest
-   * @param[out] color : linear gradient color computed
+   * @param[out] color : linear gradient color computed, rvb
    */
   /* -----------------------------------------------------------*/
   void linearColorGradient(
       const std::vector<double> &compConcentration,
       int pos,
-      std::vector<unsigned char> &color);
+      unsigned char color[3]);
 
   /* -----------------------------------------------------------*/
   /** 
@@ -175,12 +173,13 @@ private:
   /** 
    * @brief Convert a form into cubes to be drawn by vtk
    * Convert concentration of energy, oxygen, glucose, lactate in cubes
+   * Only the cubes which differ from the form drawn before are updated.
    */
   /* -----------------------------------------------------------*/
   void drawForm();
 
   /* data */
-  GraphManager &_gm; /*!< graph of form to be drawn*/
+  FormPager _forms; /*!< forms to be drawn*/
   std::vector<double> _bgColor; /*!< background color for the vtk window*/
   std::vector<int> _dim; /*!< Dimension of the 3D space*/
 
@@ -212,6 +211,7 @@ private:
   vtkSmartPointer<vtkGlyph3D> _cubeGlyph3D;
   vtkSmartPointer<vtkPolyDataMapper> _cubeMapper;
   vtkSmartPointer<vtkActor> _cubeActor;
+  std::vector<int> _cubeCells; /*!< cell where each cube is drawn*/
 
   /**
    * VTK objects for drawing multiple cubes
@@ -226,9 +226,6 @@ private:
   vtkSmartPointer<vtkActor> _concActor;
 
   int _formIndex; /*!< index of the current form*/
-  boost::dynamic_bitset<> _form; /*!< dynamic_bytset of the current form*/
-  std::vector<double> _EForm; /*!< energy of the environment*/
-  std::vector<double> _OForm; /*!< oxygen of the environment*/
-  std::vector<double> _GForm; /*!< glucose of the environment*/
-  std::vector<double> _LForm; /*!< lactate of the environment*/
+  boost::shared_ptr<const PagedForm> _page; /*!< current form and its env*/
+  boost::shared_ptr<const PagedForm> _drawnPage; /*!< form in the cubes*/
 };
@@ -0,0 +1,46 @@
+/**
+ * @file GridKernel.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "GridKernel.hpp"
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Fill the kernel set with the W x H specialization
+ */
+/* -----------------------------------------------------------*/
+template <unsigned int W, unsigned int H>
+static void setGridKernel(GridKernelSet &kernels)
+{
+  kernels.loadBoard = &GridKernel<W, H>::loadBoard;
+  kernels.storeKey = &GridKernel<W, H>::storeKey;
+}
+
+bool selectGridKernel(
+    unsigned int height,
+    unsigned int width,
+    GridKernelSet &kernels)
+{
+  if (height != width) return false;
+
+  switch (width)
+  {
+    case 8:
+      setGridKernel<8, 8>(kernels);
+      return true;
+    case 10:
+      setGridKernel<10, 10>(kernels);
+      return true;
+    case 16:
+      setGridKernel<16, 16>(kernels);
+      return true;
+    case 32:
+      setGridKernel<32, 32>(kernels);
+      return true;
+    default:
+      return false;
+  }
+}
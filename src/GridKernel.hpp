@@ -0,0 +1,141 @@
+/**
+ * @file GridKernel.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef GRIDKERNEL_HPP
+#define GRIDKERNEL_HPP
+
+/* boost include */
+#include <boost/static_assert.hpp>
+
+/* project include */
+#include "FormTransform.hpp"
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Board kernels specialized for a grid of W x H cells
+ * The grid size being known at compile time, the rows are read from and
+ * written to the blocks of the form with constant offsets and masks. The
+ * results are the same as loadBoard and storeBoard.
+ */
+/* -----------------------------------------------------------*/
+template <unsigned int W, unsigned int H>
+class GridKernel
+{
+public:
+  BOOST_STATIC_ASSERT(W <= 64 && H <= 64);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief loadBoard for a form of W x H cells
+   */
+  /* -----------------------------------------------------------*/
+  static bool loadBoard(
+      const graphVertex &form,
+      RowBoard &board);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Write a cropped form in the top left corner of the key grid
+   * The key grid is a square whose side is the biggest of W and H,
+   * see Environment::canonicalForm
+   */
+  /* -----------------------------------------------------------*/
+  static void storeKey(
+      const RowBoard &board,
+      graphVertex &key);
+
+private:
+  BOOST_STATIC_ASSERT(graphVertex::bits_per_block == 64);
+
+  static const unsigned int SIZE = W * H;
+  static const unsigned int SIDE = W > H ? W : H;
+  static const unsigned int KEY_SIZE = SIDE * SIDE;
+};
+
+template <unsigned int W, unsigned int H>
+bool GridKernel<W, H>::loadBoard(
+    const graphVertex &form,
+    RowBoard &board)
+{
+  if (form.size() != SIZE) return ::loadBoard(form, W, board);
+
+  // a row crossing a block boundary ends in the next block
+  const boost::uint64_t *words = form.blocks();
+  const boost::uint64_t rowMask = W == 64 ? ~(boost::uint64_t)0 : ((boost::uint64_t)1 << W) - 1;
+  boost::uint64_t rows[H], columns = 0;
+  unsigned int first = H, last = 0;
+  for (unsigned int r = 0; r < H; r++)
+  {
+    const unsigned int word = r * W / 64, bit = r * W % 64;
+    rows[r] = words[word] >> bit;
+    if (bit + W > 64) rows[r] |= words[word + 1] << (64 - bit);
+    rows[r] &= rowMask;
+    if (rows[r])
+    {
+      if (first == H) first = r;
+      last = r;
+      columns |= rows[r];
+    }
+  }
+  if (!columns) return false;
+
+  board.row = first;
+  board.height = last - first + 1;
+  board.col = lowestBit(columns);
+  board.width = highestBit(columns) + 1 - board.col;
+  for (unsigned int r = 0; r < board.height; r++)
+    board.rows[r] = rows[first + r] >> board.col;
+  return true;
+}
+
+template <unsigned int W, unsigned int H>
+void GridKernel<W, H>::storeKey(
+    const RowBoard &board,
+    graphVertex &key)
+{
+  key.resize(KEY_SIZE);
+  key.reset();
+
+  boost::uint64_t *words = key.blocks();
+  for (unsigned int r = 0; r < board.height; r++)
+  {
+    const unsigned int word = r * SIDE / 64, bit = r * SIDE % 64;
+    words[word] |= board.rows[r] << bit;
+    if (bit + board.width > 64) words[word + 1] |= board.rows[r] >> (64 - bit);
+  }
+}
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Kernels used by an Environment, specialized or not
+ */
+/* -----------------------------------------------------------*/
+struct GridKernelSet
+{
+  bool (*loadBoard)(const graphVertex &, RowBoard &);
+  void (*storeKey)(const RowBoard &, graphVertex &);
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Pick the kernels specialized for a grid size
+ *
+ * @param[in] height : height of the grid
+ * @param[in] width : width of the grid
+ * @param[out] kernels : specialized kernels if found
+ *
+ * @return false if no specialization exists for this grid size, the generic
+ * loadBoard and storeBoard have to be used
+ * Specializations exist for 8x8, 10x10, 16x16 and 32x32 grids.
+ */
+/* -----------------------------------------------------------*/
+bool selectGridKernel(
+    unsigned int height,
+    unsigned int width,
+    GridKernelSet &kernels);
+
+#endif
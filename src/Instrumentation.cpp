@@ -0,0 +1,120 @@
+/**
+ * @file Instrumentation.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "Instrumentation.hpp"
+
+#ifdef MILLENIUM_CELL_INSTRUMENTATION
+
+#define BOOST_CHRONO_HEADER_ONLY
+
+#include <boost/atomic.hpp>
+#include <boost/chrono/chrono.hpp>
+
+#include "AllocationCounter.hpp"
+
+// The allocations are counted by AllocationCounter since the start : their
+// totals hold the count at the previous dump instead.
+static boost::atomic<boost::uint64_t> totals[Instrumentation::NB_COUNTERS];
+
+static bool isAllocationCounter(Instrumentation::Counter counter)
+{
+  return counter == Instrumentation::ALLOCATIONS ||
+    counter == Instrumentation::BYTES_ALLOCATED;
+}
+
+static boost::uint64_t getAllocationCount(Instrumentation::Counter counter)
+{
+  return counter == Instrumentation::ALLOCATIONS ?
+    AllocationCounter::getNbAllocations() :
+    AllocationCounter::getBytesAllocated();
+}
+
+bool Instrumentation::isEnabled()
+{
+  return true;
+}
+
+void Instrumentation::add(
+    Counter counter,
+    boost::uint64_t value)
+{
+  totals[counter].fetch_add(value, boost::memory_order_relaxed);
+}
+
+boost::uint64_t Instrumentation::get(Counter counter)
+{
+  boost::uint64_t value = totals[counter].load(boost::memory_order_relaxed);
+  if (isAllocationCounter(counter)) value = getAllocationCount(counter) - value;
+  return value;
+}
+
+void Instrumentation::dump(
+    std::ostream &os,
+    unsigned int timestep)
+{
+  os << "{\"timestep\": " << timestep;
+  for (int c = 0; c < NB_COUNTERS; c++)
+  {
+    boost::uint64_t value;
+    if (isAllocationCounter(Counter(c)))
+    {
+      boost::uint64_t count = getAllocationCount(Counter(c));
+      value = count - totals[c].exchange(count, boost::memory_order_relaxed);
+    } else {
+      value = totals[c].exchange(0, boost::memory_order_relaxed);
+    }
+    os << ", \"" << getName(Counter(c)) << "\": " << value;
+  }
+  os << "}" << std::endl;
+}
+
+boost::uint64_t Instrumentation::now()
+{
+  return boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+      boost::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#else
+
+boost::uint64_t Instrumentation::get(Counter)
+{
+  return 0;
+}
+
+void Instrumentation::dump(
+    std::ostream &/*os*/,
+    unsigned int /*timestep*/)
+{
+}
+
+#endif
+
+const char* Instrumentation::getName(Counter counter)
+{
+  static const char *names[NB_COUNTERS] = {
+    "children_attempted",
+    "children_rejected_by_mitose",
+    "children_rejected_by_can_mitose",
+    "duplicate_hits",
+    "duplicate_hits_identity",
+    "duplicate_hits_vert_sym",
+    "duplicate_hits_hor_sym",
+    "duplicate_hits_rotation180",
+    "duplicate_hits_transpose",
+    "duplicate_hits_rotation90",
+    "duplicate_hits_rotation270",
+    "duplicate_hits_anti_transpose",
+    "env_cache_hits",
+    "env_recomputations",
+    "reaction_ns",
+    "dedup_ns",
+    "insertion_ns",
+    "allocations",
+    "bytes_allocated"
+  };
+  return names[counter];
+}
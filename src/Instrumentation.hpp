@@ -0,0 +1,179 @@
+/**
+ * @file Instrumentation.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * Counters of the hot paths, compiled in with the
+ * MILLENIUM_CELL_INSTRUMENTATION definition (cmake -DINSTRUMENTATION=ON).
+ * Without it the classes below are empty and their functions do nothing, so
+ * that the instrumented code compiles to the same code as before.
+ */
+
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+/* std include */
+#include <ostream>
+
+/* boost include */
+#include <boost/cstdint.hpp>
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Process wide totals of the counters
+ */
+/* -----------------------------------------------------------*/
+class Instrumentation
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Counters of the instrumentation
+   */
+  /* -----------------------------------------------------------*/
+  enum Counter
+  {
+    CHILDREN_ATTEMPTED, /*!< mitoses tried, a cell and a control*/
+    CHILDREN_REJECTED_BY_MITOSE, /*!< no free cell for the daughter*/
+    CHILDREN_REJECTED_BY_CANMITOSE, /*!< not enough energy or too much lactate*/
+    DUPLICATE_HITS, /*!< children equivalent to a form already reached*/
+    DUPLICATE_HITS_IDENTITY, /*!< duplicate hits by the Symmetry taking the
+                               child onto the form already reached, in the
+                               order of Symmetry*/
+    DUPLICATE_HITS_VERT_SYM,
+    DUPLICATE_HITS_HOR_SYM,
+    DUPLICATE_HITS_ROTATION180,
+    DUPLICATE_HITS_TRANSPOSE,
+    DUPLICATE_HITS_ROTATION90,
+    DUPLICATE_HITS_ROTATION270,
+    DUPLICATE_HITS_ANTI_TRANSPOSE,
+    ENV_CACHE_HITS, /*!< lazy env found in the cache*/
+    ENV_RECOMPUTATIONS, /*!< lazy env recomputed*/
+    REACTION_NS, /*!< reactions and mitoses, summed over the threads*/
+    DEDUP_NS, /*!< canonical keys and their lookup, summed over the threads*/
+    INSERTION_NS, /*!< forms and edges added to the graph*/
+    ALLOCATIONS, /*!< operator new calls*/
+    BYTES_ALLOCATED, /*!< bytes asked to operator new*/
+    NB_COUNTERS
+  };
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief True if the instrumentation is compiled in
+   */
+  /* -----------------------------------------------------------*/
+  static bool isEnabled();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Add to a total, from any thread
+   */
+  /* -----------------------------------------------------------*/
+  static void add(
+      Counter counter,
+      boost::uint64_t value = 1);
+
+  static boost::uint64_t get(Counter counter);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Name of a counter in the log, as "children_attempted"
+   */
+  /* -----------------------------------------------------------*/
+  static const char* getName(Counter counter);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Write the totals since the previous dump as a JSON object on one
+   * line, then reset them
+   *
+   * @param os : log
+   * @param timestep : timestep written with the totals
+   */
+  /* -----------------------------------------------------------*/
+  static void dump(
+      std::ostream &os,
+      unsigned int timestep);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Current time in nanoseconds, 0 without the instrumentation
+   */
+  /* -----------------------------------------------------------*/
+  static boost::uint64_t now();
+};
+
+#ifdef MILLENIUM_CELL_INSTRUMENTATION
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Counters of a thread, added to the totals by flush or when
+ * destroyed, so that a hot loop does not touch the shared totals
+ */
+/* -----------------------------------------------------------*/
+class InstrumentationCounters
+{
+public:
+  InstrumentationCounters()
+  {
+    for (int c = 0; c < Instrumentation::NB_COUNTERS; c++) _values[c] = 0;
+  }
+  ~InstrumentationCounters() { flush(); }
+
+  void add(Instrumentation::Counter counter, boost::uint64_t value = 1)
+  {
+    _values[counter] += value;
+  }
+
+  void flush()
+  {
+    for (int c = 0; c < Instrumentation::NB_COUNTERS; c++)
+    {
+      if (_values[c])
+        Instrumentation::add(Instrumentation::Counter(c), _values[c]);
+      _values[c] = 0;
+    }
+  }
+
+private:
+  boost::uint64_t _values[Instrumentation::NB_COUNTERS];
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Time since construction
+ */
+/* -----------------------------------------------------------*/
+class InstrumentationTimer
+{
+public:
+  InstrumentationTimer() : _start(Instrumentation::now()) {}
+  boost::uint64_t elapsed() const { return Instrumentation::now() - _start; }
+
+private:
+  boost::uint64_t _start;
+};
+
+#else
+
+inline bool Instrumentation::isEnabled() { return false; }
+inline void Instrumentation::add(Counter, boost::uint64_t) {}
+inline boost::uint64_t Instrumentation::now() { return 0; }
+
+class InstrumentationCounters
+{
+public:
+  void add(Instrumentation::Counter, boost::uint64_t = 1) {}
+  void flush() {}
+};
+
+class InstrumentationTimer
+{
+public:
+  boost::uint64_t elapsed() const { return 0; }
+};
+
+#endif
+
+#endif
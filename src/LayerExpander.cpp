@@ -0,0 +1,220 @@
+/**
+ * @file LayerExpander.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "LayerExpander.hpp"
+
+#include <algorithm>
+
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Trace.hpp"
+
+// The controls which indicates the direction of mitosis, in the order in
+// which they are tried
+static const char directions[4] = {'u', 'd', 'r', 'l'};
+
+LayerExpander::LayerExpander(
+    Environment &env,
+    const GraphManager &gm,
+    bool healthy,
+    unsigned int nbThreads) :
+  _env(env),
+  _gm(gm),
+  _healthy(healthy),
+  _nbThreads(nbThreads ? nbThreads : 1),
+  _maxSize(env.getWidth() * env.getHeight()),
+  _dim(3),
+  _parents(NULL),
+  _expansions(NULL),
+  _first(0),
+  _last(0),
+  _next(0),
+  _nbCalls(0),
+  _nbHelpers(0),
+  _nbWorking(0),
+  _closing(false)
+{
+  _dim[0] = env.getWidth();
+  _dim[1] = env.getHeight();
+  _dim[2] = 1;
+
+  // the calling thread of expand works with the helpers
+  for (unsigned int t = 0; t + 1 < _nbThreads; t++)
+    _helpers.create_thread(boost::bind(&LayerExpander::help, this, t));
+}
+
+LayerExpander::~LayerExpander()
+{
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    _closing = true;
+  }
+  _started.notify_all();
+  _helpers.join_all();
+}
+
+void LayerExpander::expand(
+    const std::vector<Vertex> &parents,
+    std::size_t first,
+    std::size_t last,
+    std::vector<LayerExpansion> &expansions)
+{
+  // expansions are kept between calls so that their buffers are reused
+  if (expansions.size() < last - first) expansions.resize(last - first);
+
+  _parents = &parents;
+  _expansions = &expansions;
+  _first = first;
+  _last = last;
+  _next = first;
+
+  unsigned int nbHelpers = 0;
+  if (last - first > 1) nbHelpers = std::min<std::size_t>(_nbThreads, last - first) - 1;
+
+  if (nbHelpers) {
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      _nbCalls++;
+      _nbHelpers = nbHelpers;
+      _nbWorking = nbHelpers;
+    }
+    _started.notify_all();
+  }
+  work();
+
+  // the helpers read the parents and write the expansions until they are done
+  boost::mutex::scoped_lock lock(_mutex);
+  while (_nbWorking) _finished.wait(lock);
+}
+
+void LayerExpander::help(unsigned int helper)
+{
+  unsigned long nbCalls = 0;
+  for (;;) {
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      while (_nbCalls == nbCalls && !_closing) _started.wait(lock);
+      if (_closing) return;
+      nbCalls = _nbCalls;
+      // the calls with fewer parents than threads do not need every helper
+      if (helper >= _nbHelpers) continue;
+    }
+    work();
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      _nbWorking--;
+    }
+    _finished.notify_one();
+  }
+}
+
+void LayerExpander::work()
+{
+  InstrumentationCounters counters;
+  TraceScope workScope(TRACE_EXPAND_WORK, _first);
+  for (std::size_t i = _next++; i < _last; i = _next++)
+    expandParent(_gm.getForm((*_parents)[i]), (*_expansions)[i - _first],
+        counters);
+}
+
+void LayerExpander::clearEnv(LayerExpansion &expansion) const
+{
+  if (expansion.energy.size() != _maxSize) {
+    expansion.energy.assign(_maxSize, 0.0);
+    expansion.oxygen.assign(_maxSize, 0.0);
+    expansion.glucose.assign(_maxSize, 0.0);
+    expansion.lactate.assign(_maxSize, 0.0);
+  } else {
+    for (graphVertex::size_type pos = expansion.cells.find_first();
+         pos != graphVertex::npos; pos = expansion.cells.find_next(pos)) {
+      expansion.energy[pos] = 0.0;
+      expansion.oxygen[pos] = 0.0;
+      expansion.glucose[pos] = 0.0;
+      expansion.lactate[pos] = 0.0;
+    }
+  }
+}
+
+void LayerExpander::react(
+    const graphVertex &form,
+    LayerExpansion &expansion) const
+{
+  // every cell of the form ends its reactions in the same state, see
+  // GraphManager::react
+  const double *cell = _gm.getReactedCell(_healthy);
+  clearEnv(expansion);
+  for (graphVertex::size_type pos = form.find_first();
+       pos != graphVertex::npos; pos = form.find_next(pos))
+  {
+    expansion.energy[pos] = cell[ENERGY];
+    expansion.oxygen[pos] = cell[OXYGEN];
+    expansion.glucose[pos] = cell[GLUCOSE];
+    expansion.lactate[pos] = cell[LACTATE];
+  }
+  expansion.cells = form;
+}
+
+void LayerExpander::expandParent(
+    const graphVertex &form,
+    LayerExpansion &expansion,
+    InstrumentationCounters &counters)
+{
+  InstrumentationTimer expansionTimer;
+  boost::uint64_t keyNs = 0;
+  const double *cell = _gm.getReactedCell(_healthy);
+  expansion.children.clear();
+  clearEnv(expansion);
+
+  // The cells of the form which have a free neighbour for each control,
+  // found with a few word shifts of the whole form
+  graphVertex mothers[4];
+  for (int d = 0; d < 4; d++)
+    mothers[d] = _env.mitoseMask(form, directions[d]);
+
+  // Process each cell of the form : its reactions, then its mitoses with
+  // each control
+  for (graphVertex::size_type pos = form.find_first();
+       pos != graphVertex::npos; pos = form.find_next(pos))
+  {
+    expansion.energy[pos] = cell[ENERGY];
+    expansion.oxygen[pos] = cell[OXYGEN];
+    expansion.glucose[pos] = cell[GLUCOSE];
+    expansion.lactate[pos] = cell[LACTATE];
+
+    for (int d = 0; d < 4; d++)
+    {
+      counters.add(Instrumentation::CHILDREN_ATTEMPTED);
+      if (!mothers[d][pos])
+      {
+        counters.add(Instrumentation::CHILDREN_REJECTED_BY_MITOSE);
+        continue;
+      }
+      if (!_gm.canMitose(pos, directions[d], _dim,
+            expansion.energy, expansion.lactate, _healthy))
+      {
+        counters.add(Instrumentation::CHILDREN_REJECTED_BY_CANMITOSE);
+        continue;
+      }
+
+      // Create the daughter cell within a copy of the current form
+      LayerChild child;
+      child.form = form;
+      child.form.set(_env.daughterPosition(pos, directions[d]));
+      InstrumentationTimer keyTimer;
+      child.key = _env.canonicalForm(child.form, child.symmetry);
+      keyNs += keyTimer.elapsed();
+      child.control = directions[d];
+      child.mitoser = pos;
+      expansion.children.push_back(child);
+    }
+  }
+  expansion.cells = form;
+
+  counters.add(Instrumentation::DEDUP_NS, keyNs);
+  counters.add(Instrumentation::REACTION_NS, expansionTimer.elapsed() - keyNs);
+}
@@ -0,0 +1,189 @@
+/**
+ * @file LayerExpander.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef LAYEREXPANDER_HPP
+#define LAYEREXPANDER_HPP
+
+/* std include */
+#include <cstddef>
+#include <vector>
+
+/* boost include */
+#include <boost/atomic.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/* project include */
+#include "GraphManager.hpp"
+#include "Instrumentation.hpp"
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief A form reached by a mitosis of a parent form
+ */
+/* -----------------------------------------------------------*/
+struct LayerChild
+{
+  graphVertex form; /*!< parent form with the daughter cell*/
+  graphVertex key; /*!< canonical key of form*/
+  unsigned int symmetry; /*!< Symmetry of form which is the key*/
+  char control; /*!< direction of the mitosis*/
+  unsigned int mitoser; /*!< position of the mother cell*/
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Everything computed from one parent form of a timestep
+ */
+/* -----------------------------------------------------------*/
+struct LayerExpansion
+{
+  /* env of the parent after the reactions, saved with its new children */
+  std::vector<double> energy;
+  std::vector<double> oxygen;
+  std::vector<double> glucose;
+  std::vector<double> lactate;
+  graphVertex cells; /*!< cells set in the env, the others are 0*/
+  std::vector<LayerChild> children; /*!< in the order of the serial loop*/
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Expand the parents of a timestep on several threads
+ * The expansion of a parent (reactions, mitoses and canonical keys) only
+ * reads the form graph, the Environment and the GraphManager parameters, so
+ * the parents are shared between threads which take them one at a time from
+ * a common counter. The helper threads are started once by the constructor
+ * and woken for each call of expand. Each result is written at the index of
+ * its parent: the caller merges them into the graph after expand returns, in
+ * the order of the parents, which gives the same graph whatever the number
+ * of threads.
+ */
+/* -----------------------------------------------------------*/
+class LayerExpander
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Constructor
+   *
+   * @param env : grid of the forms
+   * @param gm : graph manager holding the parents and the reaction parameters
+   * @param healthy : true if healthy, false if cancerous
+   * @param nbThreads : number of threads, 0 or 1 expands on the calling thread
+   */
+  /* -----------------------------------------------------------*/
+  LayerExpander(
+      Environment &env,
+      const GraphManager &gm,
+      bool healthy,
+      unsigned int nbThreads);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Destructor, stop the helper threads
+   */
+  /* -----------------------------------------------------------*/
+  ~LayerExpander();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Expand the parents [first, last) of a timestep
+   *
+   * @param[in] parents : vertices of the parents in the form graph
+   * @param[in] first : first parent to expand
+   * @param[in] last : end of the parents to expand
+   * @param[out] expansions : expansion of parents[first + i] at index i
+   * The form graph must not be modified before expand returns.
+   */
+  /* -----------------------------------------------------------*/
+  void expand(
+      const std::vector<Vertex> &parents,
+      std::size_t first,
+      std::size_t last,
+      std::vector<LayerExpansion> &expansions);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Do the reactions of a form
+   *
+   * @param[in] form : form of cells
+   * @param[out] expansion : env of the form after the reactions, the children
+   * are left unchanged
+   */
+  /* -----------------------------------------------------------*/
+  void react(
+      const graphVertex &form,
+      LayerExpansion &expansion) const;
+
+  unsigned int getNbThreads() const { return _nbThreads; }
+
+private:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Expand parents until the counter passes the last one
+   */
+  /* -----------------------------------------------------------*/
+  void work();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Loop of a helper thread, which works on each call of expand
+   * needing it until the destructor stops it
+   *
+   * @param helper : index of the helper, from 0
+   */
+  /* -----------------------------------------------------------*/
+  void help(unsigned int helper);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Reset the env of an expansion to 0
+   * Only the cells of the previous form are reset, so that reusing an
+   * expansion costs the size of the forms and not the size of the grid.
+   */
+  /* -----------------------------------------------------------*/
+  void clearEnv(LayerExpansion &expansion) const;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Do the reactions of a form and find its mitoses, in a single
+   * pass over the cells of the form
+   */
+  /* -----------------------------------------------------------*/
+  void expandParent(
+      const graphVertex &form,
+      LayerExpansion &expansion,
+      InstrumentationCounters &counters);
+
+  Environment &_env;
+  const GraphManager &_gm;
+  bool _healthy;
+  unsigned int _nbThreads;
+  std::size_t _maxSize; /*!< number of cells of the grid*/
+  std::vector<int> _dim; /*!< dimension of the env*/
+
+  /* current call of expand */
+  const std::vector<Vertex> *_parents;
+  std::vector<LayerExpansion> *_expansions;
+  std::size_t _first;
+  std::size_t _last;
+  boost::atomic<std::size_t> _next; /*!< next parent to expand*/
+
+  /* helper threads */
+  boost::mutex _mutex;
+  boost::condition_variable _started; /*!< a call of expand or the end*/
+  boost::condition_variable _finished; /*!< a helper is done with a call*/
+  unsigned long _nbCalls; /*!< calls of expand which needed helpers*/
+  unsigned int _nbHelpers; /*!< helpers working on the current call*/
+  unsigned int _nbWorking; /*!< helpers not done with the current call*/
+  bool _closing;
+  boost::thread_group _helpers;
+};
+
+#endif
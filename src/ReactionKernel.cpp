@@ -0,0 +1,51 @@
+/**
+ * @file ReactionKernel.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "ReactionKernel.hpp"
+
+ReactionKernel::ReactionKernel(
+    double inGlu,
+    double inOxy,
+    double outEneOxy,
+    double outEneNoOxy,
+    double outLac,
+    bool lacOnOxy,
+    double eneMitose) :
+  _inGlu(inGlu),
+  _inOxy(inOxy),
+  _outEneOxy(outEneOxy),
+  _outEneNoOxy(outEneNoOxy),
+  _outLac(outLac),
+  _lacOnOxy(lacOnOxy),
+  _eneMitose(eneMitose)
+{
+}
+
+void ReactionKernel::react(
+    double *energy,
+    double *oxygen,
+    double *glucose,
+    double *lactate,
+    std::size_t n) const
+{
+  for (std::size_t i = 0; i < n; i++)
+  {
+    while (glucose[i] >= _inGlu && energy[i] < _eneMitose)
+    {
+      glucose[i] -= _inGlu;
+      if (oxygen[i] >= _inOxy)
+      {
+        oxygen[i] -= _inOxy;
+        energy[i] += _outEneOxy;
+        if (_lacOnOxy) lactate[i] += _outLac;
+      } else {
+        energy[i] += _outEneNoOxy;
+        lactate[i] += _outLac;
+      }
+    }
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file ReactionKernel.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef REACTIONKERNEL_HPP
+#define REACTIONKERNEL_HPP
+
+/* std include */
+#include <cstddef>
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Reactions of cells
+ * A reaction step consumes glucose and, if there is enough oxygen, oxygen
+ * too (breathing), otherwise the cell ferments. Steps are repeated while the
+ * cell has enough glucose and not enough energy for a mitosis. The cells are
+ * given as arrays : the i-th value of each array is the i-th cell.
+ */
+/* -----------------------------------------------------------*/
+class ReactionKernel
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Constructor
+   *
+   * @param inGlu : glucose consumed by a step
+   * @param inOxy : oxygen consumed by a breathing step
+   * @param outEneOxy : energy produced by a breathing step
+   * @param outEneNoOxy : energy produced by a fermenting step
+   * @param outLac : lactate produced by a fermenting step
+   * @param lacOnOxy : true if a breathing step produces outLac too
+   * @param eneMitose : energy needed for a mitosis, which ends the steps
+   * The healthy reaction of GraphManager is (hInGlu, hInOxy, hOutEneOxy,
+   * hOutEneNoOxy, hOutLac, false, eneMitose), the cancerous one (cInGlu,
+   * cInOxy, cOutEne, cOutEne, cOutLac, true, eneMitose).
+   */
+  /* -----------------------------------------------------------*/
+  ReactionKernel(
+      double inGlu,
+      double inOxy,
+      double outEneOxy,
+      double outEneNoOxy,
+      double outLac,
+      bool lacOnOxy,
+      double eneMitose);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief React n cells
+   *
+   * @param[in, out] energy : energy of each cell
+   * @param[in, out] oxygen : oxygen of each cell
+   * @param[in, out] glucose : glucose of each cell
+   * @param[in, out] lactate : lactate of each cell
+   * @param[in] n : number of cells
+   */
+  /* -----------------------------------------------------------*/
+  void react(
+      double *energy,
+      double *oxygen,
+      double *glucose,
+      double *lactate,
+      std::size_t n) const;
+
+private:
+  double _inGlu;
+  double _inOxy;
+  double _outEneOxy;
+  double _outEneNoOxy;
+  double _outLac;
+  bool _lacOnOxy;
+  double _eneMitose;
+};
+
+#endif
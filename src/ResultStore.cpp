@@ -0,0 +1,525 @@
+/**
+ * @file ResultStore.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "ResultStore.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/bind/bind.hpp>
+#include <boost/static_assert.hpp>
+
+#include "Trace.hpp"
+
+BOOST_STATIC_ASSERT(sizeof(ResultStoreHeader) % 8 == 0);
+BOOST_STATIC_ASSERT(sizeof(StoredTimestepHeader) % 8 == 0);
+BOOST_STATIC_ASSERT(sizeof(StoredEdge) == 16);
+
+static const char MAGIC[8] = "MCELLRS";
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Write the elements of a vector at the end of the store
+ */
+/* -----------------------------------------------------------*/
+template <class T>
+static void writeSection(std::ostream &os, const std::vector<T> &values)
+{
+  if (!values.empty())
+    os.write(reinterpret_cast<const char *>(&values[0]),
+        values.size() * sizeof(T));
+}
+
+void StoredTimestep::swap(StoredTimestep &other)
+{
+  forms.swap(other.forms);
+  parents.swap(other.parents);
+  for (unsigned int c = 0; c < NB_CONCENTRATIONS; c++)
+    concentrations[c].swap(other.concentrations[c]);
+  edgeIndex.swap(other.edgeIndex);
+  edges.swap(other.edges);
+}
+
+void getStoredTimestep(
+    const GraphManager &gm,
+    std::size_t sourceFirst,
+    std::size_t first,
+    std::size_t last,
+    std::size_t firstId,
+    StoredTimestep &timestep)
+{
+  const Graph &g = gm.getGForm();
+
+  // the buffers are kept, they come back from the writer once written
+  timestep.forms.clear();
+  timestep.parents.clear();
+  for (unsigned int c = 0; c < NB_CONCENTRATIONS; c++)
+    timestep.concentrations[c].clear();
+  timestep.edgeIndex.clear();
+  timestep.edges.clear();
+
+  for (std::size_t v = first; v < last; v++)
+  {
+    const graphVertex &form = gm.getForm(v);
+    timestep.forms.insert(timestep.forms.end(), form.blocks(),
+        form.blocks() + form.num_blocks());
+    timestep.parents.push_back(gm.getParent(v) == NO_PARENT ?
+        ~(boost::uint64_t)0 : firstId + gm.getParent(v));
+  }
+
+  const ConcentrationArena &arena = gm.getConcentrations();
+  if (gm.hasLazyEnv())
+  {
+    graphVertex form;
+    std::vector<double> env[NB_CONCENTRATIONS];
+    for (std::size_t v = first; v < last; v++)
+    {
+      gm.getFormFromGraph(v, form, env[ENERGY], env[OXYGEN],
+          env[GLUCOSE], env[LACTATE]);
+      for (unsigned int c = 0; c < NB_CONCENTRATIONS; c++)
+        timestep.concentrations[c].insert(timestep.concentrations[c].end(),
+            env[c].begin(), env[c].end());
+    }
+  }
+
+  // each species in one copy when the arena holds doubles
+  std::vector<double> values;
+  for (unsigned int c = 0; c < NB_CONCENTRATIONS && !gm.hasLazyEnv(); c++)
+  {
+    std::vector<double> &concentration = timestep.concentrations[c];
+    const double *data = arena.data(static_cast<Concentration>(c));
+    if (data && last > first)
+    {
+      std::size_t maxSize = gm.getForm(first).size();
+      concentration.assign(data + first * maxSize, data + last * maxSize);
+      continue;
+    }
+    for (std::size_t v = first; v < last; v++)
+    {
+      arena.get(static_cast<Concentration>(c), v, values);
+      concentration.insert(concentration.end(), values.begin(), values.end());
+    }
+  }
+
+  // out edges of each form of the previous timestep in the order of the
+  // graph
+  timestep.edgeIndex.push_back(0);
+  for (std::size_t v = sourceFirst; v < first; v++)
+  {
+    boost::graph_traits< Graph >::out_edge_iterator e, end;
+    for (boost::tie(e, end) = boost::out_edges(v, g); e != end; ++e)
+    {
+      const graphEdge &p = g[*e];
+      StoredEdge edge;
+      std::memset(&edge, 0, sizeof(edge));
+      edge.target = firstId + boost::target(*e, g);
+      edge.mitoser = p.Mitoser;
+      edge.temps = p.Temps;
+      edge.control = p.Control;
+      timestep.edges.push_back(edge);
+    }
+    timestep.edgeIndex.push_back(timestep.edges.size());
+  }
+}
+
+ResultStoreWriter::ResultStoreWriter(
+    const std::string &fileName,
+    const std::vector<double> &parameters,
+    unsigned int height,
+    unsigned int width,
+    bool healthy) :
+  _fileName(fileName),
+  _file(fileName.c_str(),
+      std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc),
+  _firstForms(1, 0),
+  _end(0),
+  _nbTimesteps(0),
+  _hasWaiting(false),
+  _closing(false),
+  _closed(false),
+  _failed(false)
+{
+  if (!_file) throw std::runtime_error("cannot create the result store " + fileName);
+
+  std::memset(&_header, 0, sizeof(_header));
+  std::memcpy(_header.magic, MAGIC, sizeof(MAGIC));
+  _header.version = RESULT_STORE_VERSION;
+  _header.healthy = healthy;
+  _header.height = height;
+  _header.width = width;
+  _header.formBlocks = Form(height * width).num_blocks();
+  std::copy(parameters.begin(),
+      parameters.begin() + std::min<std::size_t>(parameters.size(), NB_PARAMETERS),
+      _header.parameters);
+
+  // the empty index of a store without timestep
+  _header.indexOffset = sizeof(_header);
+  _file.write(reinterpret_cast<const char *>(&_header), sizeof(_header));
+  writeSection(_file, _firstForms);
+  _file.flush();
+  if (!_file) throw std::runtime_error("cannot write the result store " + fileName);
+  _end = _file.tellp();
+
+  start();
+}
+
+ResultStoreWriter::ResultStoreWriter(const std::string &fileName) :
+  _fileName(fileName),
+  _file(fileName.c_str(), std::ios::in | std::ios::out | std::ios::binary),
+  _end(0),
+  _nbTimesteps(0),
+  _hasWaiting(false),
+  _closing(false),
+  _closed(false),
+  _failed(false)
+{
+  if (!_file) throw std::runtime_error("cannot open the result store " + fileName);
+
+  _file.read(reinterpret_cast<char *>(&_header), sizeof(_header));
+  if (!_file || std::memcmp(_header.magic, MAGIC, sizeof(MAGIC)))
+    throw std::runtime_error(fileName + " is not a result store");
+  if (_header.version != RESULT_STORE_VERSION)
+    throw std::runtime_error(fileName + " has an unknown result store version");
+
+  _nbTimesteps = _header.nbTimesteps;
+  _firstForms.resize(_nbTimesteps + 1);
+  _offsets.resize(_nbTimesteps);
+  _file.seekg(_header.indexOffset);
+  _file.read(reinterpret_cast<char *>(&_firstForms[0]),
+      _firstForms.size() * sizeof(boost::uint64_t));
+  if (_nbTimesteps)
+    _file.read(reinterpret_cast<char *>(&_offsets[0]),
+        _offsets.size() * sizeof(boost::uint64_t));
+  if (!_file) throw std::runtime_error(fileName + " is truncated");
+
+  // the timesteps are added after the end of the file, whatever is there
+  // being left as it is until the header points to them
+  _file.seekp(0, std::ios::end);
+  _end = _file.tellp();
+
+  start();
+}
+
+ResultStoreWriter::~ResultStoreWriter()
+{
+  try {
+    close();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+void ResultStoreWriter::add(StoredTimestep &timestep)
+{
+  boost::mutex::scoped_lock lock(_mutex);
+  while (_hasWaiting && !_failed) _changed.wait(lock);
+  if (_failed)
+    throw std::runtime_error("cannot write the result store " + _fileName);
+
+  _waiting.swap(timestep);
+  _hasWaiting = true;
+  _nbTimesteps++;
+  _changed.notify_all();
+}
+
+void ResultStoreWriter::close()
+{
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    if (_closed) return;
+    _closing = true;
+    _changed.notify_all();
+  }
+  _thread.join();
+  _closed = true;
+  _file.close();
+  if (_failed)
+    throw std::runtime_error("cannot write the result store " + _fileName);
+}
+
+void ResultStoreWriter::start()
+{
+  _thread = boost::thread(boost::bind(&ResultStoreWriter::run, this));
+}
+
+void ResultStoreWriter::run()
+{
+  StoredTimestep timestep;
+  for (;;) {
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      while (!_hasWaiting && !_closing) _changed.wait(lock);
+      if (!_hasWaiting) break;
+      // the buffers of the timestep written go back to the caller
+      timestep.swap(_waiting);
+      _hasWaiting = false;
+      _changed.notify_all();
+      if (_failed) continue;
+    }
+
+    write(timestep);
+    if (!_file) {
+      boost::mutex::scoped_lock lock(_mutex);
+      _failed = true;
+      _changed.notify_all();
+    }
+  }
+}
+
+void ResultStoreWriter::write(const StoredTimestep &timestep)
+{
+  TraceScope scope(TRACE_SAVE, _firstForms.size() - 1);
+
+  StoredTimestepHeader header;
+  header.nbForms = timestep.parents.size();
+  header.nbSources = timestep.edgeIndex.size() - 1;
+  header.nbEdges = timestep.edges.size();
+
+  // the section then the index after it, the previous ones being still in
+  // use until the header is written
+  _file.seekp(_end);
+  _file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  writeSection(_file, timestep.forms);
+  writeSection(_file, timestep.parents);
+  for (unsigned int c = 0; c < NB_CONCENTRATIONS; c++)
+    writeSection(_file, timestep.concentrations[c]);
+  writeSection(_file, timestep.edgeIndex);
+  writeSection(_file, timestep.edges);
+
+  _offsets.push_back(_end);
+  _firstForms.push_back(_firstForms.back() + header.nbForms);
+  boost::uint64_t indexOffset = _file.tellp();
+  writeSection(_file, _firstForms);
+  writeSection(_file, _offsets);
+  _end = _file.tellp();
+  _file.flush();
+
+  _header.nbTimesteps++;
+  _header.nbForms += header.nbForms;
+  _header.nbEdges += header.nbEdges;
+  _header.indexOffset = indexOffset;
+  _file.seekp(0);
+  _file.write(reinterpret_cast<const char *>(&_header), sizeof(_header));
+  _file.flush();
+}
+
+void saveResultStore(
+    const std::string &fileName,
+    const GraphManager &gm,
+    const std::vector<unsigned int> &verticesPerTimestep,
+    unsigned int height,
+    unsigned int width,
+    bool healthy)
+{
+  ResultStoreWriter writer(fileName, gm.getParameters(), height, width,
+      healthy);
+
+  // each timestep is copied while the previous one is written
+  StoredTimestep timestep;
+  std::size_t sourceFirst = 0, first = 0;
+  for (std::size_t t = 0; t < verticesPerTimestep.size(); t++)
+  {
+    std::size_t last = first + verticesPerTimestep[t];
+    getStoredTimestep(gm, sourceFirst, first, last, 0, timestep);
+    writer.add(timestep);
+    sourceFirst = first;
+    first = last;
+  }
+  writer.close();
+}
+
+void loadResultStore(
+    const ResultStore &store,
+    GraphManager &gm,
+    std::vector<unsigned int> &verticesPerTimestep,
+    unsigned int height,
+    unsigned int width,
+    bool healthy)
+{
+  TraceScope scope(TRACE_LOAD);
+  const ResultStoreHeader &header = store.getHeader();
+  if (header.height != height || header.width != width ||
+      (bool)header.healthy != healthy)
+    throw std::runtime_error("the result store was computed for another env");
+  std::vector<double> parameters = gm.getParameters();
+  if (parameters.size() != NB_PARAMETERS ||
+      !std::equal(parameters.begin(), parameters.end(), header.parameters))
+    throw std::runtime_error("the result store was computed with other thresholds");
+  if (gm.getMaxNbrOfForm())
+    throw std::runtime_error("a result store is loaded in an empty graph manager");
+
+  graphVertex form;
+  std::vector<double> energy, oxygen, glucose, lactate;
+  gm.reserveForms(header.nbForms);
+  for (std::size_t v = 0; v < header.nbForms; v++)
+  {
+    store.getFormFromGraph(v, form, energy, oxygen, glucose, lactate);
+    gm.add_vertexToGForm(form, energy, oxygen, glucose, lactate,
+        store.getParent(v));
+  }
+
+  for (std::size_t v = 0; v < header.nbForms; v++)
+  {
+    const StoredEdge *edge, *end;
+    for (store.getOutEdges(v, edge, end); edge != end; ++edge)
+    {
+      graphEdge p;
+      p.Control = edge->control;
+      p.Mitoser = edge->mitoser;
+      p.Temps = edge->temps;
+      gm.add_edgeToGForm(v, edge->target, p);
+    }
+  }
+
+  verticesPerTimestep.clear();
+  for (unsigned int t = 0; t < header.nbTimesteps; t++)
+  {
+    std::size_t first, last;
+    store.getTimestep(t, first, last);
+    verticesPerTimestep.push_back(last - first);
+  }
+}
+
+ResultStore::ResultStore(const std::string &fileName) :
+  _file(fileName.c_str(), boost::interprocess::read_only),
+  _region(_file, boost::interprocess::read_only),
+  _data(static_cast<const char *>(_region.get_address())),
+  _header(reinterpret_cast<const ResultStoreHeader *>(_data)),
+  _maxSize(0),
+  _firstForms(NULL)
+{
+  std::size_t size = _region.get_size();
+  if (size < sizeof(ResultStoreHeader) ||
+      std::memcmp(_header->magic, MAGIC, sizeof(MAGIC)))
+    throw std::runtime_error(fileName + " is not a result store");
+  if (_header->version != RESULT_STORE_VERSION)
+    throw std::runtime_error(fileName + " has an unknown result store version");
+
+  _maxSize = _header->height * _header->width;
+  unsigned int nbTimesteps = _header->nbTimesteps;
+  if (_header->indexOffset +
+      (2 * nbTimesteps + 1) * sizeof(boost::uint64_t) > size)
+    throw std::runtime_error(fileName + " is truncated");
+  _firstForms = section<boost::uint64_t>(_header->indexOffset);
+  const boost::uint64_t *offsets = _firstForms + nbTimesteps + 1;
+
+  // the sections of every timestep, checked once here
+  _timesteps.resize(nbTimesteps);
+  for (unsigned int t = 0; t < nbTimesteps; t++)
+  {
+    TimestepSections &sections = _timesteps[t];
+    boost::uint64_t offset = offsets[t];
+    if (offset + sizeof(StoredTimestepHeader) > size)
+      throw std::runtime_error(fileName + " is truncated");
+    sections.header = section<StoredTimestepHeader>(offset);
+    const StoredTimestepHeader &header = *sections.header;
+    if (header.nbForms != _firstForms[t + 1] - _firstForms[t] ||
+        header.nbSources != (t ? _firstForms[t] - _firstForms[t - 1] : 0))
+      throw std::runtime_error(fileName + " has an invalid index");
+
+    offset += sizeof(StoredTimestepHeader);
+    sections.forms = section<boost::uint64_t>(offset);
+    offset += header.nbForms * _header->formBlocks * sizeof(boost::uint64_t);
+    sections.parents = section<boost::uint64_t>(offset);
+    offset += header.nbForms * sizeof(boost::uint64_t);
+    for (unsigned int c = 0; c < NB_CONCENTRATIONS; c++)
+    {
+      sections.concentrations[c] = section<double>(offset);
+      offset += header.nbForms * _maxSize * sizeof(double);
+    }
+    sections.edgeIndex = section<boost::uint64_t>(offset);
+    offset += (header.nbSources + 1) * sizeof(boost::uint64_t);
+    sections.edges = section<StoredEdge>(offset);
+    offset += header.nbEdges * sizeof(StoredEdge);
+    if (offset > size) throw std::runtime_error(fileName + " is truncated");
+  }
+}
+
+unsigned int ResultStore::findTimestep(std::size_t index) const
+{
+  return std::upper_bound(_firstForms,
+      _firstForms + _header->nbTimesteps + 1, index) - _firstForms - 1;
+}
+
+void ResultStore::getTimestep(
+    unsigned int timestep,
+    std::size_t &first,
+    std::size_t &last) const
+{
+  first = _firstForms[timestep];
+  last = _firstForms[timestep + 1];
+}
+
+const boost::uint64_t *ResultStore::getFormBlocks(std::size_t index) const
+{
+  unsigned int t = findTimestep(index);
+  return _timesteps[t].forms +
+    (index - _firstForms[t]) * _header->formBlocks;
+}
+
+const double *ResultStore::getConcentration(
+    Concentration concentration,
+    std::size_t index) const
+{
+  unsigned int t = findTimestep(index);
+  return _timesteps[t].concentrations[concentration] +
+    (index - _firstForms[t]) * _maxSize;
+}
+
+Vertex ResultStore::getParent(std::size_t index) const
+{
+  unsigned int t = findTimestep(index);
+  boost::uint64_t parent = _timesteps[t].parents[index - _firstForms[t]];
+  return parent == ~(boost::uint64_t)0 ? NO_PARENT : parent;
+}
+
+void ResultStore::getOutEdges(
+    std::size_t index,
+    const StoredEdge *&begin,
+    const StoredEdge *&end) const
+{
+  // the edges leaving a form are kept with the timestep they reach
+  unsigned int t = findTimestep(index);
+  if (t + 1 >= _header->nbTimesteps)
+  {
+    begin = end = NULL;
+    return;
+  }
+  const TimestepSections &next = _timesteps[t + 1];
+  std::size_t source = index - _firstForms[t];
+  begin = next.edges + next.edgeIndex[source];
+  end = next.edges + next.edgeIndex[source + 1];
+}
+
+int ResultStore::getMaxNbrOfForm() const
+{
+  return _header->nbForms;
+}
+
+void ResultStore::getFormFromGraph(
+    int index,
+    graphVertex &form,
+    std::vector<double> &energy,
+    std::vector<double> &oxygen,
+    std::vector<double> &glucose,
+    std::vector<double> &lactate) const
+{
+  form.resize(_maxSize);
+  std::copy(getFormBlocks(index), getFormBlocks(index) + _header->formBlocks,
+      form.blocks());
+
+  const double *values = getConcentration(ENERGY, index);
+  energy.assign(values, values + _maxSize);
+  values = getConcentration(OXYGEN, index);
+  oxygen.assign(values, values + _maxSize);
+  values = getConcentration(GLUCOSE, index);
+  glucose.assign(values, values + _maxSize);
+  values = getConcentration(LACTATE, index);
+  lactate.assign(values, values + _maxSize);
+}
@@ -0,0 +1,411 @@
+/**
+ * @file ResultStore.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef RESULTSTORE_HPP
+#define RESULTSTORE_HPP
+
+/* std include */
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* boost include */
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/* project include */
+#include "ConcentrationArena.hpp"
+#include "FormSource.hpp"
+#include "GraphManager.hpp"
+
+const unsigned int RESULT_STORE_VERSION = 3;
+const unsigned int NB_PARAMETERS = 16; /*!< see GraphManager::getParameters*/
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief First bytes of a result store
+ * A store is made of this header followed by a section per timestep, written
+ * one after the other as the timesteps are done, and of the index of these
+ * sections, written after the last one. The offsets are in bytes from the
+ * start of the file, every section starts on 8 bytes and the numbers are in
+ * the byte order of the machine that wrote the store.
+ *
+ * A timestep is added by writing its section and a new index after the end
+ * of the file, then the header pointing to them : the store stays readable
+ * at every moment, as its previous timesteps if the writing stops.
+ */
+/* -----------------------------------------------------------*/
+struct ResultStoreHeader
+{
+  char magic[8]; /*!< "MCELLRS"*/
+  boost::uint32_t version; /*!< RESULT_STORE_VERSION*/
+  boost::uint32_t healthy; /*!< 1 if healthy cells, 0 if cancerous*/
+  boost::uint32_t height; /*!< height of the grid*/
+  boost::uint32_t width; /*!< width of the grid*/
+  boost::uint32_t formBlocks; /*!< 64 bits blocks of a form*/
+  boost::uint32_t nbTimesteps;
+  boost::uint64_t nbForms;
+  boost::uint64_t nbEdges;
+  double parameters[NB_PARAMETERS]; /*!< thresholds of the GraphManager*/
+  /* nbTimesteps + 1 uint64, first form of each timestep then nbForms,
+   * followed by nbTimesteps uint64, the offset of each timestep section */
+  boost::uint64_t indexOffset;
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief First bytes of the section of a timestep
+ * It is followed by nbForms x formBlocks uint64, the cells of each form,
+ * nbForms uint64, the parent of each form with all bits set for none,
+ * nbForms x height x width double for each Concentration, nbSources + 1
+ * uint64, the first edge of each form of the previous timestep then nbEdges,
+ * and nbEdges StoredEdge, the edges reaching the timestep sorted by source.
+ */
+/* -----------------------------------------------------------*/
+struct StoredTimestepHeader
+{
+  boost::uint64_t nbForms;
+  boost::uint64_t nbSources; /*!< forms of the previous timestep*/
+  boost::uint64_t nbEdges;
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Edge of a result store, its source being given by the edge index
+ */
+/* -----------------------------------------------------------*/
+struct StoredEdge
+{
+  boost::uint32_t target; /*!< reached form*/
+  boost::uint32_t mitoser; /*!< position of the mother cell*/
+  boost::int32_t temps; /*!< timestep of the mitosis*/
+  char control; /*!< direction of the mitosis*/
+  char padding[3];
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief A timestep to be written in a store, see StoredTimestepHeader
+ */
+/* -----------------------------------------------------------*/
+struct StoredTimestep
+{
+  std::vector<boost::uint64_t> forms;
+  std::vector<boost::uint64_t> parents;
+  std::vector<double> concentrations[NB_CONCENTRATIONS];
+  std::vector<boost::uint64_t> edgeIndex;
+  std::vector<StoredEdge> edges;
+
+  void swap(StoredTimestep &other);
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Copy a timestep of a graph manager
+ *
+ * @param[in] gm : graph manager holding the timestep
+ * @param[in] sourceFirst : first form of the previous timestep, equal to
+ * first for the root
+ * @param[in] first : first form of the timestep
+ * @param[in] last : end of the forms of the timestep
+ * @param[in] firstId : id in the store of the vertex 0 of gm
+ * @param[out] timestep : forms, env and edges reaching the timestep
+ */
+/* -----------------------------------------------------------*/
+void getStoredTimestep(
+    const GraphManager &gm,
+    std::size_t sourceFirst,
+    std::size_t first,
+    std::size_t last,
+    std::size_t firstId,
+    StoredTimestep &timestep);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Writer of a result store on a background thread, a timestep at a
+ * time
+ * A timestep given to add is written while the caller goes on, add only
+ * waits when a timestep is already waiting to be written, so that at most
+ * two timesteps are held.
+ */
+/* -----------------------------------------------------------*/
+class ResultStoreWriter
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Create an empty store
+   *
+   * @param fileName : name of the store to create
+   * @param parameters : thresholds of the GraphManager
+   * @param height : height of the grid
+   * @param width : width of the grid
+   * @param healthy : true if healthy, false if cancerous
+   * Throws std::runtime_error if the store cannot be created.
+   */
+  /* -----------------------------------------------------------*/
+  ResultStoreWriter(
+      const std::string &fileName,
+      const std::vector<double> &parameters,
+      unsigned int height,
+      unsigned int width,
+      bool healthy);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Add timesteps to an existing store
+   *
+   * @param fileName : name of the store
+   * Throws std::runtime_error if the file is not a store of this version.
+   */
+  /* -----------------------------------------------------------*/
+  explicit ResultStoreWriter(const std::string &fileName);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Wait for the timesteps added to be written, see close
+   */
+  /* -----------------------------------------------------------*/
+  ~ResultStoreWriter();
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Timesteps of the store, those waiting to be written included
+   */
+  /* -----------------------------------------------------------*/
+  unsigned int getNbTimesteps() const { return _nbTimesteps; }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Add the next timestep
+   *
+   * @param timestep : timestep to write, given back with the buffers of a
+   * timestep written to be reused
+   * Throws std::runtime_error if a previous timestep could not be written.
+   */
+  /* -----------------------------------------------------------*/
+  void add(StoredTimestep &timestep);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Wait for every timestep added to be written and close the store
+   * Throws std::runtime_error if a timestep could not be written.
+   */
+  /* -----------------------------------------------------------*/
+  void close();
+
+private:
+  void start();
+  void run();
+  void write(const StoredTimestep &timestep);
+
+  std::string _fileName;
+  std::fstream _file;
+  ResultStoreHeader _header;
+  std::vector<boost::uint64_t> _firstForms; /*!< see indexOffset*/
+  std::vector<boost::uint64_t> _offsets;
+  boost::uint64_t _end; /*!< end of the file*/
+  unsigned int _nbTimesteps;
+
+  boost::mutex _mutex;
+  boost::condition_variable _changed;
+  StoredTimestep _waiting; /*!< next timestep to write*/
+  bool _hasWaiting;
+  bool _closing;
+  bool _closed;
+  bool _failed;
+  boost::thread _thread;
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Save an enumeration result in a binary store
+ *
+ * @param[in] fileName : name of the store to create
+ * @param[in] gm : graph manager holding the forms, their env and the edges
+ * @param[in] verticesPerTimestep : number of forms added at each timestep
+ * @param[in] height : height of the grid
+ * @param[in] width : width of the grid
+ * @param[in] healthy : true if healthy, false if cancerous
+ * Throws std::runtime_error if the store cannot be written.
+ */
+/* -----------------------------------------------------------*/
+void saveResultStore(
+    const std::string &fileName,
+    const GraphManager &gm,
+    const std::vector<unsigned int> &verticesPerTimestep,
+    unsigned int height,
+    unsigned int width,
+    bool healthy);
+
+class ResultStore;
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Load a saved result in a graph manager, to continue its enumeration
+ *
+ * @param[in] store : saved result
+ * @param[in, out] gm : empty graph manager built with the thresholds of the
+ * store, receives its forms, env and edges with the same vertices
+ * @param[out] verticesPerTimestep : number of forms added at each timestep
+ * @param[in] height : height of the grid
+ * @param[in] width : width of the grid
+ * @param[in] healthy : true if healthy, false if cancerous
+ * Throws std::runtime_error if the store was computed on another grid, for
+ * another cell type or with other thresholds. The form index of gm is left
+ * empty : the forms reached later have more cells than every saved form, so
+ * they are never compared to them.
+ */
+/* -----------------------------------------------------------*/
+void loadResultStore(
+    const ResultStore &store,
+    GraphManager &gm,
+    std::vector<unsigned int> &verticesPerTimestep,
+    unsigned int height,
+    unsigned int width,
+    bool healthy);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Saved result mapped in memory
+ * Nothing is read when opening the store but its index, the forms, edges and
+ * concentrations are used in place and only the pages touched are loaded by
+ * the system.
+ */
+/* -----------------------------------------------------------*/
+class ResultStore : public FormSource
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Map a store
+   *
+   * @param fileName : name of the store
+   * Throws std::runtime_error if the file is not a store of this version.
+   */
+  /* -----------------------------------------------------------*/
+  explicit ResultStore(const std::string &fileName);
+
+  const ResultStoreHeader &getHeader() const { return *_header; }
+  unsigned int getHeight() const { return _header->height; }
+  unsigned int getWidth() const { return _header->width; }
+  bool isHealthy() const { return _header->healthy; }
+  unsigned int getNbTimesteps() const { return _header->nbTimesteps; }
+  std::size_t getNbEdges() const { return _header->nbEdges; }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Forms added at a timestep
+   *
+   * @param[in] timestep : timestep, from 0 to getNbTimesteps() - 1
+   * @param[out] first : first form of the timestep
+   * @param[out] last : end of the forms of the timestep
+   */
+  /* -----------------------------------------------------------*/
+  void getTimestep(
+      unsigned int timestep,
+      std::size_t &first,
+      std::size_t &last) const;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Cells of a form, formBlocks blocks as in Form::blocks
+   */
+  /* -----------------------------------------------------------*/
+  const boost::uint64_t *getFormBlocks(std::size_t index) const;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief A concentration of the env saved with a form, height x width
+   * values
+   */
+  /* -----------------------------------------------------------*/
+  const double *getConcentration(
+      Concentration concentration,
+      std::size_t index) const;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Parent of a form, see GraphManager::getParent
+   */
+  /* -----------------------------------------------------------*/
+  Vertex getParent(std::size_t index) const;
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Edges leaving a form
+   *
+   * @param[in] index : source form
+   * @param[out] begin : first edge
+   * @param[out] end : end of the edges
+   */
+  /* -----------------------------------------------------------*/
+  void getOutEdges(
+      std::size_t index,
+      const StoredEdge *&begin,
+      const StoredEdge *&end) const;
+
+  /* FormSource, read only so that any thread can read it */
+  int getMaxNbrOfForm() const;
+  bool isConcurrent() const { return true; }
+  void getFormFromGraph(
+      int index,
+      graphVertex &form,
+      std::vector<double> &energy,
+      std::vector<double> &oxygen,
+      std::vector<double> &glucose,
+      std::vector<double> &lactate) const;
+
+private:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Sections of a timestep in the mapping
+   */
+  /* -----------------------------------------------------------*/
+  struct TimestepSections
+  {
+    const StoredTimestepHeader *header;
+    const boost::uint64_t *forms;
+    const boost::uint64_t *parents;
+    const double *concentrations[NB_CONCENTRATIONS];
+    const boost::uint64_t *edgeIndex;
+    const StoredEdge *edges;
+  };
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Section at an offset of the store
+   */
+  /* -----------------------------------------------------------*/
+  template <class T>
+  const T *section(boost::uint64_t offset) const
+  {
+    return reinterpret_cast<const T *>(_data + offset);
+  }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Timestep of a form
+   */
+  /* -----------------------------------------------------------*/
+  unsigned int findTimestep(std::size_t index) const;
+
+  boost::interprocess::file_mapping _file;
+  boost::interprocess::mapped_region _region;
+  const char *_data; /*!< start of the mapping*/
+  const ResultStoreHeader *_header;
+  std::size_t _maxSize; /*!< cells of the grid*/
+  const boost::uint64_t *_firstForms; /*!< first form of each timestep*/
+  std::vector<TimestepSections> _timesteps;
+};
+
+#endif
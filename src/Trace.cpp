@@ -0,0 +1,269 @@
+/**
+ * @file Trace.cpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "Trace.hpp"
+
+#ifdef MILLENIUM_CELL_INSTRUMENTATION
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Region kept in the timeline
+ */
+/* -----------------------------------------------------------*/
+struct TraceEvent
+{
+  boost::uint64_t start;
+  boost::uint64_t duration;
+  boost::uint64_t arg;
+  TraceRegion region;
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Totals of a kind of region
+ */
+/* -----------------------------------------------------------*/
+struct TraceTotals
+{
+  TraceTotals() : count(0), totalNs(0), maxNs(0), kept(0) {}
+
+  boost::uint64_t count;
+  boost::uint64_t totalNs;
+  boost::uint64_t maxNs;
+  boost::uint64_t kept;
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Ring buffer of a thread, shown as a lane of the timeline
+ * A buffer is given back when its thread ends and taken by the next thread
+ * started, the threads of the expander being started for each batch.
+ */
+/* -----------------------------------------------------------*/
+struct TraceBuffer
+{
+  explicit TraceBuffer(unsigned int lane) : lane(lane), nbKept(0) {}
+
+  unsigned int lane;
+  std::vector<TraceEvent> events;
+  boost::uint64_t nbKept; /*!< events kept, the oldest being overwritten*/
+  TraceTotals totals[NB_TRACE_REGIONS];
+};
+
+static void releaseBuffer(TraceBuffer *buffer);
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Buffers of every thread
+ * Never destroyed, the threads still running at exit giving back their
+ * buffer after the static objects are destroyed.
+ */
+/* -----------------------------------------------------------*/
+struct TraceRegistry
+{
+  TraceRegistry() :
+    thresholdNs(10000),
+    samplingPeriod(1000),
+    capacity(1 << 16),
+    current(releaseBuffer)
+  {
+  }
+
+  boost::uint64_t thresholdNs;
+  unsigned int samplingPeriod;
+  std::size_t capacity;
+
+  boost::mutex mutex;
+  std::vector<TraceBuffer *> buffers;
+  std::vector<TraceBuffer *> freeBuffers;
+  boost::thread_specific_ptr<TraceBuffer> current;
+};
+
+static TraceRegistry &registry()
+{
+  static TraceRegistry *registry = new TraceRegistry;
+  return *registry;
+}
+
+static void releaseBuffer(TraceBuffer *buffer)
+{
+  TraceRegistry &r = registry();
+  boost::mutex::scoped_lock lock(r.mutex);
+  r.freeBuffers.push_back(buffer);
+}
+
+static TraceBuffer *acquireBuffer()
+{
+  TraceRegistry &r = registry();
+  TraceBuffer *buffer;
+  {
+    boost::mutex::scoped_lock lock(r.mutex);
+    if (r.freeBuffers.empty()) {
+      buffer = new TraceBuffer(r.buffers.size());
+      r.buffers.push_back(buffer);
+    } else {
+      // the lowest lane, so that the lanes of the threads stay the same
+      std::vector<TraceBuffer *>::iterator lowest = r.freeBuffers.begin();
+      for (std::vector<TraceBuffer *>::iterator it = r.freeBuffers.begin();
+           it != r.freeBuffers.end(); ++it)
+        if ((*it)->lane < (*lowest)->lane) lowest = it;
+      buffer = *lowest;
+      r.freeBuffers.erase(lowest);
+    }
+  }
+  r.current.reset(buffer);
+  return buffer;
+}
+
+void Trace::configure(
+    boost::uint64_t thresholdNs,
+    unsigned int samplingPeriod,
+    std::size_t capacity)
+{
+  TraceRegistry &r = registry();
+  boost::mutex::scoped_lock lock(r.mutex);
+  r.thresholdNs = thresholdNs;
+  r.samplingPeriod = samplingPeriod;
+  r.capacity = std::max<std::size_t>(capacity, 1);
+}
+
+void Trace::record(
+    TraceRegion region,
+    boost::uint64_t start,
+    boost::uint64_t end,
+    boost::uint64_t arg)
+{
+  TraceRegistry &r = registry();
+  TraceBuffer *buffer = r.current.get();
+  if (!buffer) buffer = acquireBuffer();
+
+  boost::uint64_t duration = end - start;
+  TraceTotals &totals = buffer->totals[region];
+  totals.count++;
+  totals.totalNs += duration;
+  totals.maxNs = std::max(totals.maxNs, duration);
+
+  // the short regions are only counted, but for one in a sampling period
+  if (duration < r.thresholdNs &&
+      (!r.samplingPeriod || (totals.count - 1) % r.samplingPeriod))
+    return;
+
+  TraceEvent event;
+  event.start = start;
+  event.duration = duration;
+  event.arg = arg;
+  event.region = region;
+  if (buffer->events.size() < r.capacity)
+    buffer->events.push_back(event);
+  else
+    buffer->events[buffer->nbKept % r.capacity] = event;
+  buffer->nbKept++;
+  totals.kept++;
+}
+
+bool Trace::write(const std::string &fileName)
+{
+  TraceRegistry &r = registry();
+  boost::mutex::scoped_lock lock(r.mutex);
+
+  std::ofstream os(fileName.c_str(), std::ios::out);
+  if (!os) return false;
+
+  // the timeline starts at the first region kept
+  boost::uint64_t origin = std::numeric_limits<boost::uint64_t>::max();
+  for (std::size_t b = 0; b < r.buffers.size(); b++)
+    for (std::size_t e = 0; e < r.buffers[b]->events.size(); e++)
+      origin = std::min(origin, r.buffers[b]->events[e].start);
+
+  os.setf(std::ios::fixed);
+  os.precision(3);
+  os << "{\"traceEvents\": [" << std::endl;
+  os << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, "
+    "\"args\": {\"name\": \"Millenium-Cell\"}}";
+  for (std::size_t b = 0; b < r.buffers.size(); b++)
+    os << "," << std::endl
+      << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+      << r.buffers[b]->lane << ", \"args\": {\"name\": \"lane "
+      << r.buffers[b]->lane << "\"}}";
+
+  // the times of a Chrome trace are in microseconds
+  TraceTotals totals[NB_TRACE_REGIONS];
+  boost::uint64_t dropped = 0;
+  for (std::size_t b = 0; b < r.buffers.size(); b++) {
+    const TraceBuffer &buffer = *r.buffers[b];
+    for (std::size_t e = 0; e < buffer.events.size(); e++) {
+      const TraceEvent &event = buffer.events[e];
+      os << "," << std::endl
+        << "{\"name\": \"" << getName(event.region)
+        << "\", \"cat\": \"millenium_cell\", \"ph\": \"X\", \"pid\": 1, "
+        << "\"tid\": " << buffer.lane
+        << ", \"ts\": " << (event.start - origin) * 1e-3
+        << ", \"dur\": " << event.duration * 1e-3
+        << ", \"args\": {\"arg\": " << event.arg << "}}";
+    }
+    for (int k = 0; k < NB_TRACE_REGIONS; k++) {
+      totals[k].count += buffer.totals[k].count;
+      totals[k].totalNs += buffer.totals[k].totalNs;
+      totals[k].maxNs = std::max(totals[k].maxNs, buffer.totals[k].maxNs);
+      totals[k].kept += buffer.totals[k].kept;
+    }
+    dropped += buffer.nbKept - buffer.events.size();
+  }
+  os << std::endl << "]," << std::endl;
+
+  os << "\"displayTimeUnit\": \"ns\"," << std::endl;
+  os << "\"otherData\": {\"threshold_ns\": " << r.thresholdNs
+    << ", \"sampling_period\": " << r.samplingPeriod
+    << ", \"overwritten\": " << dropped << ", \"regions\": {";
+  bool first = true;
+  for (int k = 0; k < NB_TRACE_REGIONS; k++) {
+    if (!totals[k].count) continue;
+    os << (first ? "" : ",") << std::endl
+      << "  \"" << getName(TraceRegion(k)) << "\": {\"count\": "
+      << totals[k].count << ", \"total_ns\": " << totals[k].totalNs
+      << ", \"max_ns\": " << totals[k].maxNs
+      << ", \"kept\": " << totals[k].kept << "}";
+    first = false;
+  }
+  os << std::endl << "}}}" << std::endl;
+
+  return bool(os);
+}
+
+#else
+
+bool Trace::write(const std::string &/*fileName*/)
+{
+  return false;
+}
+
+#endif
+
+const char* Trace::getName(TraceRegion region)
+{
+  static const char *names[NB_TRACE_REGIONS] = {
+    "MilleniumCell::EnumerationEngine::expandTimestep",
+    "MilleniumCell::LayerExpander::expand",
+    "MilleniumCell::LayerExpander::work",
+    "MilleniumCell::EnumerationEngine::insertBatch",
+    "MilleniumCell::ExternalFrontier::merge",
+    "MilleniumCell::Environment::canonicalForm",
+    "MilleniumCell::GraphManager::findForm",
+    "MilleniumCell::saveResultStore",
+    "MilleniumCell::loadResultStore",
+    "MilleniumCell::FormPager::load"
+  };
+  return names[region];
+}
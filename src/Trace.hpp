@@ -0,0 +1,162 @@
+/**
+ * @file Trace.hpp
+ * @author Kwon-Young Choi
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * Timeline of the enumeration, written as a Chrome trace (chrome://tracing,
+ * ui.perfetto.dev). Compiled in with the instrumentation, see
+ * Instrumentation.hpp, and empty without it.
+ *
+ * Each thread records the regions it leaves in its own ring buffer, without
+ * lock. Every region is added to the totals of its kind, but only the regions
+ * longer than a threshold, and one in a sampling period of the shorter ones,
+ * are kept in the timeline, so that a long run keeps a bounded trace.
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+/* std include */
+#include <cstddef>
+#include <string>
+
+/* boost include */
+#include <boost/cstdint.hpp>
+
+/* project include */
+#include "Instrumentation.hpp"
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Regions of the timeline
+ * Their names are those of the functions they time, without space, so that
+ * they read as the symbols of a perf profile.
+ */
+/* -----------------------------------------------------------*/
+enum TraceRegion
+{
+  TRACE_TIMESTEP, /*!< a whole timestep*/
+  TRACE_EXPAND_BATCH, /*!< a batch of parents expanded on every thread*/
+  TRACE_EXPAND_WORK, /*!< the parents of a batch expanded by one thread*/
+  TRACE_INSERT_BATCH, /*!< the children of a batch added to the graph*/
+  TRACE_FRONTIER_MERGE, /*!< the spilled children merged*/
+  TRACE_CANONICAL_FORM, /*!< canonical key of a form computed*/
+  TRACE_FIND_FORM, /*!< canonical key looked up in the form index*/
+  TRACE_SAVE, /*!< result store written*/
+  TRACE_LOAD, /*!< result store loaded in a graph manager*/
+  TRACE_VIEWER_LOAD, /*!< form loaded for the viewer by its pager*/
+  NB_TRACE_REGIONS
+};
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Process wide timeline
+ */
+/* -----------------------------------------------------------*/
+class Trace
+{
+public:
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Name of a region, as "MilleniumCell::LayerExpander::expand"
+   */
+  /* -----------------------------------------------------------*/
+  static const char* getName(TraceRegion region);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Set how the regions are kept, before any region is recorded
+   *
+   * @param thresholdNs : regions at least this long are always kept
+   * @param samplingPeriod : one in samplingPeriod shorter regions of a kind
+   * is kept, 0 for none
+   * @param capacity : regions kept by each thread, the oldest being
+   * overwritten
+   */
+  /* -----------------------------------------------------------*/
+  static void configure(
+      boost::uint64_t thresholdNs,
+      unsigned int samplingPeriod,
+      std::size_t capacity);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Record a region left by the calling thread
+   *
+   * @param region : kind of the region
+   * @param start : Instrumentation::now() when entered
+   * @param end : Instrumentation::now() when left
+   * @param arg : number shown with the region, a timestep or a batch
+   */
+  /* -----------------------------------------------------------*/
+  static void record(
+      TraceRegion region,
+      boost::uint64_t start,
+      boost::uint64_t end,
+      boost::uint64_t arg);
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Write the timeline as a Chrome trace, the totals of every kind of
+   * region being given in otherData
+   * No region must be recorded meanwhile.
+   *
+   * @param fileName : trace to create
+   *
+   * @return false if it cannot be written or without the instrumentation
+   */
+  /* -----------------------------------------------------------*/
+  static bool write(const std::string &fileName);
+};
+
+#ifdef MILLENIUM_CELL_INSTRUMENTATION
+
+/* -----------------------------------------------------------*/
+/**
+ * @brief Region of the timeline from the construction to the destruction
+ */
+/* -----------------------------------------------------------*/
+class TraceScope
+{
+public:
+  explicit TraceScope(TraceRegion region, boost::uint64_t arg = 0) :
+    _region(region),
+    _arg(arg),
+    _start(Instrumentation::now())
+  {
+  }
+  ~TraceScope()
+  {
+    Trace::record(_region, _start, Instrumentation::now(), _arg);
+  }
+
+  /* -----------------------------------------------------------*/
+  /**
+   * @brief Change the kind of the region once its outcome is known
+   */
+  /* -----------------------------------------------------------*/
+  void setRegion(TraceRegion region) { _region = region; }
+
+private:
+  TraceRegion _region;
+  boost::uint64_t _arg;
+  boost::uint64_t _start;
+};
+
+#else
+
+class TraceScope
+{
+public:
+  explicit TraceScope(TraceRegion, boost::uint64_t = 0) {}
+  void setRegion(TraceRegion) {}
+};
+
+inline void Trace::configure(boost::uint64_t, unsigned int, std::size_t) {}
+inline void Trace::record(TraceRegion, boost::uint64_t, boost::uint64_t,
+    boost::uint64_t) {}
+
+#endif
+
+#endif
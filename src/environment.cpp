@@ -1,6 +1,9 @@
 
 #include <iostream>
 #include "environment.h"
+#include "FormTransform.hpp"
+#include "GridKernel.hpp"
+#include "Trace.hpp"
 
 // Create an environment with a wished number of cells and form dimensions
 Environment::Environment(unsigned int maxCell, unsigned int height,
@@ -9,6 +12,24 @@ Environment::Environment(unsigned int maxCell, unsigned int height,
   _maxCell = maxCell;
   _width = width;
   _height = height;
+
+  // Column masks preventing mitoses from wrapping around the grid sides
+  _notFirstCol.resize(height * width, true);
+  _notLastCol.resize(height * width, true);
+  for (unsigned int row = 0; row < height; row++) {
+    _notFirstCol.reset(row * width);
+    _notLastCol.reset(row * width + width - 1);
+  }
+
+  // Use the kernels compiled for this grid size if there are some
+  GridKernelSet kernels;
+  if (selectGridKernel(height, width, kernels)) {
+    _loadBoard = kernels.loadBoard;
+    _storeKey = kernels.storeKey;
+  } else {
+    _loadBoard = NULL;
+    _storeKey = NULL;
+  }
 }
 
 Environment::~Environment() {}
@@ -22,351 +43,239 @@ unsigned int Environment::getHeight() { return _height; }
 // Get the maximum width of forms
 unsigned int Environment::getWidth() { return _width; }
 
-// Allow to make shift and rotate operations on the dynamic bitset for shape
-// translation
-boost::dynamic_bitset<> Environment::ror(boost::dynamic_bitset<> transForm,
-                                         unsigned int nbBits)
+// Crop the form to its bounding box, with the kernel specialized for the grid
+// size if there is one
+bool Environment::loadFormBoard(const graphVertex &form, RowBoard &board)
 {
-  unsigned int maxSize = _height * _width;
-  return (transForm >> nbBits) | (transForm << maxSize - nbBits);
+  if (_loadBoard) return _loadBoard(form, board);
+
+  return loadBoard(form, _width, board);
 }
 
-// return the centroid of a form
-unsigned int Environment::findCentroid(boost::dynamic_bitset<> form,
-                                       boost::dynamic_bitset<> &oneBit,
-                                       unsigned int &pos)
+// Shift the form to the top left corner of its bounding box : all the
+// translations of a form have the same normalized form
+graphVertex
+Environment::normalizeTranslation(const graphVertex &form)
 {
-  unsigned int maxSize = _height * _width;
-  boost::dynamic_bitset<> noBit(maxSize, 0);
+  RowBoard board;
+  graphVertex normForm;
 
-  while ((form & oneBit) == noBit) {
-    oneBit >>= 1;
-    --pos;
+  if (loadFormBoard(form, board)) {
+    storeBoard(board, 0, 0, _height, _width, normForm);
+    return normForm;
   }
 
-  return pos;
-}
+  // the bounding box does not fit in a RowBoard, shift the whole form by its
+  // first row and its leftmost column
+  size_t first = form.find_first();
+  if (first == graphVertex::npos) return form;
 
-// Give the result of all possible translations of the given form in the grid
-unsigned int Environment::translationResult(Graph g,
-                                            vector< unsigned int > vertices,
-                                            boost::dynamic_bitset<> form)
-{
-  int maxSize = _height * _width - 1;
-  boost::dynamic_bitset<> copyForm = form;
-
-  while (maxSize >= 0) {
-    // compare the successive translation with each node referenced in the
-    // vector
-    // and return the reference if there is a correspondance, else continue
-    // rotating
-    for (vector< unsigned int >::iterator it(vertices.begin());
-         it != vertices.end(); it++) {
-      if (g[*it] == copyForm) return *it;
-    }
-
-    copyForm = ror(form, maxSize);
+  size_t leftCol = _width;
+  for (size_t i = first; i != graphVertex::npos;
+       i = form.find_next(i))
+    leftCol = min(leftCol, i % _width);
 
-    maxSize--;
-  }
-
-  return 0;
+  return form >> ((first / _width) * _width + leftCol);
 }
 
-// The algorithm implementing the formula of form rotation through 270 degrees
-unsigned int Environment::rotation270Result(boost::dynamic_bitset<> &form,
-                                            unsigned int centroidPos)
+// Store the normalized translation of a form, a translation already stored
+// keeping its first vertex
+void Environment::indexTranslation(TranslationIndex &index,
+                                   const graphVertex &form,
+                                   unsigned int vertex)
 {
-  unsigned int maxSize = _height * _width;
-  boost::dynamic_bitset<> rotForm(maxSize);
-  unsigned int centroidRow = (int)centroidPos / _width;
-  unsigned int centroidCol = (int)centroidPos % _width;
-  unsigned int formSize = 0;
-  unsigned int nbCells = form.count();
-  unsigned int spread, cellNewCol, cellNewRow, cellNewPos;
-
-  for (unsigned int i = 0; i < maxSize; i++) {
-    if (form[i]) {
-      unsigned int celCol = (int)(i % _width);
-      unsigned int celRow = (int)(i / _width);
-
-      if (celCol < centroidCol) {
-        spread = centroidCol - celCol;
-        cellNewRow = centroidRow + spread;
-      }
-
-      else {
-        spread = celCol - centroidCol;
-        cellNewRow = centroidRow - spread;
-      }
-
-      if (celRow < centroidRow) {
-        spread = centroidRow - celRow;
-        cellNewCol = centroidCol - spread;
-      } else {
-        spread = celRow - centroidRow;
-        cellNewCol = centroidCol + spread;
-      }
-
-      cellNewPos = cellNewRow * _width + cellNewCol;
-
-      if (cellNewPos < maxSize) {
-        rotForm.set(cellNewPos);
-      } else
-        return formSize;
-
-      formSize++;
-    }
-
-    if (formSize == nbCells) break;
-  }
-
-  // Assert if new position is allocated to all cells or not
-  form = rotForm;
-  return formSize;
+  index.insert(TranslationIndex::value_type(normalizeTranslation(form),
+                                            vertex));
 }
 
-// The algorithm implementing the formula of form rotation through 180 degrees
-unsigned int Environment::rotation180Result(boost::dynamic_bitset<> &form,
-                                            unsigned int centroidPos)
+// Store the normalized translations of the forms referenced in the vector, in
+// the order of the vector
+void Environment::indexTranslations(const Graph &g,
+                                    const vector< unsigned int > &vertices,
+                                    TranslationIndex &index)
 {
-  unsigned int maxSize = _height * _width;
-  boost::dynamic_bitset<> rotForm(maxSize);
-
-  unsigned int formSize = 0;
-  unsigned int nbCells = form.count();
-
-  for (unsigned int i = 0; i < maxSize; i++) {
-    if (form[i]) {
-      if ((2 * centroidPos - i) < maxSize) {
-        rotForm.set(2 * centroidPos - i);
-      } else
-        return formSize;
-
-      formSize++;
-    }
-
-    if (formSize == nbCells) break;
-  }
-
-  // Assert if new position is allocated to all cells or not
-  form = rotForm;
-  return formSize;
+  for (vector< unsigned int >::const_iterator it(vertices.begin());
+       it != vertices.end(); it++)
+    indexTranslation(index, g[*it], *it);
 }
 
-// The algorithm implementing the formula of form rotation through 90 degree
-unsigned int Environment::rotation90Result(boost::dynamic_bitset<> &form,
-                                           unsigned int centroidPos)
+// Give the result of all possible translations of the given form in the grid
+unsigned int
+Environment::translationResult(const TranslationIndex &index,
+                               const graphVertex &form)
 {
-  unsigned int maxSize = _height * _width;
-  boost::dynamic_bitset<> rotForm(maxSize);
-  unsigned int centroidPosDiv = (int)(centroidPos / _width) * _width;
-  unsigned int centroidRow = (int)centroidPos / _width;
-  unsigned int centroidCol = centroidPos % _width;
-  unsigned int formSize = 0;
-  unsigned int nbCells = form.count();
-  unsigned int spread, n, cellNewCol, cellNewRow, cellNewPos;
-
-  for (unsigned int i = 0; i < maxSize; i++) {
-    if (form[i]) {
-      if (i < centroidPos) {
-        spread = centroidPosDiv - (int)(i / _width) * _width;
-        n = (int)spread / _width;
+  // the stored forms are normalized once by indexTranslation, only the
+  // given form is normalized here
+  TranslationIndex::const_iterator it =
+      index.find(normalizeTranslation(form));
 
-        cellNewCol = centroidCol + n;
-        cellNewRow = centroidRow - centroidCol + (i % _width);
-      }
-
-      else {
-        spread = (int)(i / _width) * _width - centroidPosDiv;
-        n = (int)spread / _width;
-        cellNewCol = centroidCol - n;
-        cellNewRow = centroidRow - centroidCol + i % _width;
-      }
-
-      cellNewPos = cellNewRow * _width + cellNewCol;
-
-      if (cellNewPos < maxSize) {
-        rotForm.set(cellNewPos);
-      } else
-        return formSize;
-
-      formSize++;
-    }
-
-    if (formSize == nbCells) break;
-  }
-
-  // Assert if new position is allocated to all cells or not
-  form = rotForm;
-  return formSize;
+  return it == index.end() ? 0 : it->second;
 }
 
-// The algorithm implementing the formula which find horizontal symmetry of the
-// form
-unsigned int Environment::horSymResult(boost::dynamic_bitset<> &form,
-                                       unsigned int centroidPos)
+// Apply a symmetry to the cropped form and write the image in the top left
+// corner of the grid. Return the number of cells of the image inside the grid,
+// lower than the number of cells of the form if the image does not fit
+unsigned int Environment::symmetryResult(graphVertex &form,
+                                         int sym)
 {
-  unsigned int maxSize = _height * _width;
-  boost::dynamic_bitset<> symForm(maxSize);
-  unsigned int symInf = (int)(centroidPos / _width) * _width;
-  unsigned int symSup = ((int)centroidPos / _width + 1) * _width;
-  unsigned int formSize = 0;
-  unsigned int nbCells = form.count();
-  unsigned int spread, cellNewRow, cellNewPos;
-
-  for (unsigned int i = 0; i < maxSize; i++) {
-    if (form[i]) {
-      if (i < symSup) {
-        spread = (int)(symSup - i) / _width;
-
-        if ((int)(symSup - i) % _width != 0) spread++;
-
-        cellNewRow = (int)(symInf / _width) + spread;
-      }
+  RowBoard board, image;
 
-      else {
-        spread = (int)(i - symSup) / _width;
+  if (!loadFormBoard(form, board)) return 0;
 
-        if ((int)(i - symSup) % _width != 0) spread++;
+  transformBoard(board, (Symmetry)sym, image);
 
-        cellNewRow = (int)(symSup / _width) - spread;
-      }
+  return storeBoard(image, 0, 0, _height, _width, form);
+}
 
-      cellNewPos = cellNewRow * _width + i % _width;
+// Rotating the form through 270 degrees
+unsigned int Environment::rotation270Result(graphVertex &form)
+{
+  return symmetryResult(form, ROTATION_270);
+}
 
-      if (cellNewPos < maxSize) {
-        symForm.set(cellNewPos);
-      } else
-        return formSize;
+// Rotating the form through 180 degrees
+unsigned int Environment::rotation180Result(graphVertex &form)
+{
+  return symmetryResult(form, ROTATION_180);
+}
 
-      formSize++;
-    }
+// Rotating the form through 90 degrees
+unsigned int Environment::rotation90Result(graphVertex &form)
+{
+  return symmetryResult(form, ROTATION_90);
+}
 
-    if (formSize == nbCells) break;
-  }
+// Find the horizontal symmetry of the form
+unsigned int Environment::horSymResult(graphVertex &form)
+{
+  return symmetryResult(form, HOR_SYM);
+}
 
-  // Assert if new position is granted to all cells by the symmetry of the form
-  // or not
-  form = symForm;
-  return formSize;
+// Find the vertical symmetry of the form
+unsigned int Environment::vertSymResult(graphVertex &form)
+{
+  return symmetryResult(form, VERT_SYM);
 }
 
-// The algorithm implementing the formula which find vertical symmetry of the
-// form
-unsigned int Environment::vertSymResult(boost::dynamic_bitset<> &form,
-                                        unsigned int centroidPos)
+// Give the result of the geometrical transformation of the form by specifying
+// the one to apply
+unsigned int Environment::geomTransResult(
+    const TranslationIndex &index, graphVertex form,
+    unsigned int (Environment::*geomTrans)(graphVertex &))
 {
-  unsigned int maxSize = _height * _width;
-  boost::dynamic_bitset<> symForm(maxSize);
-  unsigned int symInf = (int)(centroidPos % _width);
-  unsigned int symSup = ((int)centroidPos % _width + 1);
-  unsigned int formSize = 0;
   unsigned int nbCells = form.count();
-  unsigned int spread, cellNewCol, cellNewPos;
-
-  for (unsigned int i = 0; i < maxSize; i++) {
-    if (form[i]) {
-      unsigned int celCol = (int)(i % _width);
-      unsigned int celRow = (int)(i / _width);
-
-      if (celCol <= symInf) {
-        spread = symInf - celCol;
-
-        cellNewCol = symSup + spread;
-      }
 
-      else {
-        spread = celCol - symSup;
+  // the transformed form can not be in the grid if it does not fit in it
+  if ((this->*geomTrans)(form) < nbCells) return 0;
 
-        cellNewCol = symInf - spread;
-      }
-
-      cellNewPos = celRow * _width + cellNewCol;
+  return translationResult(index, form);
+}
 
-      if (cellNewPos < maxSize) {
-        symForm.set(cellNewPos);
-      } else
-        return formSize;
+// Verify If a form already exists or its geometrical transformations
+unsigned int
+Environment::existInGraph(const TranslationIndex &index,
+                          const graphVertex &form)
+{
+  unsigned int (Environment::*geomTrans[5])(graphVertex &) = {
+      &Environment::rotation270Result, &Environment::rotation180Result,
+      &Environment::rotation90Result, &Environment::horSymResult,
+      &Environment::vertSymResult};
 
-      formSize++;
-    }
+  unsigned int vertex = translationResult(index, form);
 
-    if (formSize == nbCells) break;
-  }
+  // Try each geometrical transformation until a correspondance is found
+  for (unsigned int t = 0; !vertex && t < 5; t++)
+    vertex = geomTransResult(index, form, geomTrans[t]);
 
-  // Assert if new position is granted to all cells by the symmetry of the form
-  // or not
-  form = symForm;
-  return formSize;
+  return vertex;
 }
 
-// Give the result of the geometrical transformation of the form by specifying
-// the one to apply
-unsigned int Environment::geomTransResult(
-    Graph g, vector< unsigned int > vertices, boost::dynamic_bitset<> form,
-    unsigned int (Environment::*geomTrans)(boost::dynamic_bitset<> &,
-                                           unsigned int))
+// Reduce a form to its canonical key : the 8 rotations and symmetries of the
+// square are applied to the form cropped to its bounding box, the smallest
+// image is kept and written in the top left corner of a side x side grid. Two
+// forms have the same key if and only if one is a translation, rotation or
+// symmetry of the other.
+graphVertex Environment::canonicalForm(const graphVertex &form)
 {
-  boost::dynamic_bitset<> rotForm = form;
-  unsigned int maxSize = _height * _width;
-  boost::dynamic_bitset<> oneBit(maxSize);
-  unsigned int nbCells = form.count();
-  unsigned int pos = maxSize - 1;
-
-  oneBit.set(pos);
-
-  unsigned int centroidPos = findCentroid(form, oneBit, pos);
-
-  unsigned int rotCells = (this->*geomTrans)(rotForm, centroidPos);
+  unsigned int symmetry;
+  return canonicalForm(form, symmetry);
+}
 
-  while (rotCells < nbCells) {
-    rotForm = form;
+// canonicalForm, giving the first Symmetry whose image of the form is the key
+graphVertex Environment::canonicalForm(const graphVertex &form,
+                                       unsigned int &symmetry)
+{
+  unsigned int side = std::max(_height, _width);
+  RowBoard board, images[NB_SYMMETRIES];
+  graphVertex key;
+  TraceScope scope(TRACE_CANONICAL_FORM, form.count());
 
-    oneBit >>= 1;
-    --pos;
+  if (!loadFormBoard(form, board))
+    return canonicalFormByCells(form, symmetry);
 
-    centroidPos = findCentroid(rotForm, oneBit, pos);
+  allImages(board, images);
 
-    rotCells = (this->*geomTrans)(rotForm, centroidPos);
-  }
+  unsigned int best = IDENTITY;
+  for (unsigned int sym = IDENTITY + 1; sym < NB_SYMMETRIES; sym++)
+    if (compareBoards(images[sym], images[best]) < 0) best = sym;
+  symmetry = best;
 
-  form = rotForm;
+  if (_storeKey)
+    _storeKey(images[best], key);
+  else
+    storeBoard(images[best], 0, 0, side, side, key);
 
-  return translationResult(g, vertices, form);
+  return key;
 }
 
-// Verify If a form already exists or its geometrical transformations
-unsigned int Environment::existInGraph(Graph g, boost::dynamic_bitset<> form,
-                                       vector< unsigned int > vertices)
+// canonicalForm working cell by cell, for the forms whose bounding box does
+// not fit in a RowBoard
+graphVertex Environment::canonicalFormByCells(const graphVertex &form,
+                                              unsigned int &symmetry)
 {
+  static const Symmetry symmetries[8] = {
+      IDENTITY, TRANSPOSE,    HOR_SYM,      ROTATION_270,
+      VERT_SYM, ROTATION_90, ROTATION_180, ANTI_TRANSPOSE};
+
+  unsigned int side = std::max(_height, _width);
+  vector< int > rows, cols;
+  graphVertex key;
+
+  for (size_t i = form.find_first(); i != graphVertex::npos;
+       i = form.find_next(i)) {
+    rows.push_back(i / _width);
+    cols.push_back(i % _width);
+  }
 
-  if (!translationResult(g, vertices, form)) {
-    if (!geomTransResult(g, vertices, form, &Environment::rotation270Result)) {
-      if (!geomTransResult(g, vertices, form,
-                           &Environment::rotation180Result)) {
-        if (!geomTransResult(g, vertices, form,
-                             &Environment::rotation90Result)) {
-          if (!geomTransResult(g, vertices, form, &Environment::horSymResult)) {
-            return geomTransResult(g, vertices, form,
-                                   &Environment::vertSymResult);
-          }
-          return geomTransResult(g, vertices, form, &Environment::horSymResult);
-        }
+  // bit 0 of trans swaps rows and columns, bit 1 mirrors the rows and bit 2
+  // mirrors the columns
+  for (unsigned int trans = 0; trans < 8; trans++) {
+    vector< int > newRows(rows), newCols(cols);
+    int minRow = INT_MAX, minCol = INT_MAX;
+
+    for (unsigned int c = 0; c < rows.size(); c++) {
+      if (trans & 1) swap(newRows[c], newCols[c]);
+      if (trans & 2) newRows[c] = -newRows[c];
+      if (trans & 4) newCols[c] = -newCols[c];
+      minRow = min(minRow, newRows[c]);
+      minCol = min(minCol, newCols[c]);
+    }
 
-        return geomTransResult(g, vertices, form,
-                               &Environment::rotation90Result);
-      }
-      return geomTransResult(g, vertices, form,
-                             &Environment::rotation180Result);
+    graphVertex image(side * side);
+    for (unsigned int c = 0; c < rows.size(); c++)
+      image.set((newRows[c] - minRow) * side + newCols[c] - minCol);
+
+    if (trans == 0 || image < key) {
+      key = image;
+      symmetry = symmetries[trans];
     }
-    return geomTransResult(g, vertices, form, &Environment::rotation270Result);
   }
-  return translationResult(g, vertices, form);
+
+  return key;
 }
 
 // Starting the reachable sets generation with a form
-void Environment::setForm(boost::dynamic_bitset<> form,
+void Environment::setForm(graphVertex form,
                           vector< unsigned int > positions)
 {
   for (unsigned int i = 0; i < positions.size(); i++)
@@ -374,7 +283,7 @@ void Environment::setForm(boost::dynamic_bitset<> form,
 }
 
 // Trigger a mitose
-bool Environment::mitose(boost::dynamic_bitset<> &form,
+bool Environment::mitose(graphVertex &form,
                          unsigned int motherPosition, char direction)
 {
   bool mitose = false;
@@ -435,46 +344,49 @@ bool Environment::mitose(boost::dynamic_bitset<> &form,
   return mitose;
 }
 
-// Display the final forms on a external file
-void Environment::display(boost::dynamic_bitset<> form, unsigned int formLabel)
+// Find at once all the cells of the form which can trigger a mitose with the
+// given control : the free cells of the grid are shifted onto their neighbour
+// in the mitose direction, the result keeps the cells of the form having a
+// free neighbour. The rules are the ones of mitose.
+graphVertex Environment::mitoseMask(const graphVertex &form, char direction)
 {
-  // Open a file to design the grid thanks to the formcontainer and copy down
-  // the content of the genome.
-  ofstream formFile;
+  graphVertex mothers = ~form;
 
-  formFile.open("formFile", ios::app);
-  if (formFile.bad()) {
-    cerr << "Impossible d'ouvrir le fichier !" << endl;
+  switch (direction) {
+    case 'u':
+      mothers >>= _width;
+      break;
+    case 'd':
+      mothers <<= _width;
+      break;
+    case 'l':
+      mothers >>= 1;
+      mothers &= _notLastCol;
+      break;
+    case 'r':
+      mothers <<= 1;
+      mothers &= _notFirstCol;
+      break;
+    default:
+      mothers.reset();
   }
 
-  unsigned int l = _height;
-  while (!(l == 1)) {
-    unsigned int c = 1;
-    while (c < _width) {
-      formFile << form[l * _width - c] << "     ";
-      c++;
-    }
-    formFile << form[l * _width - c];
-    formFile << endl;
-    formFile << endl;
-    formFile << endl;
-    l--;
-  }
+  mothers &= form;
+  return mothers;
+}
 
-  unsigned int c = 1;
-  while (c < _width) {
-    formFile << form[l * _width - c] << "     ";
-    c++;
+// Position of the daughter cell created by a mitose
+unsigned int Environment::daughterPosition(unsigned int motherPosition,
+                                           char direction)
+{
+  switch (direction) {
+    case 'u':
+      return motherPosition + _width;
+    case 'd':
+      return motherPosition - _width;
+    case 'l':
+      return motherPosition + 1;
+    default:
+      return motherPosition - 1;
   }
-
-  formFile << form[l * _width - c] << endl;
-
-  formFile << "=================" << endl;
-
-  formFile << "N? : " << formLabel;
-
-  formFile << endl;
-  formFile << "=================" << endl;
-
-  formFile.close();
 }
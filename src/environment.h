@@ -3,8 +3,9 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <climits>
 
-#include <boost/dynamic_bitset.hpp>
 #include <iostream>
 
 #include <boost/graph/graph_traits.hpp>
@@ -13,13 +14,15 @@
 #include <boost/graph/filtered_graph.hpp>
 #include <boost/graph/graph_utility.hpp>
 #include <boost/graph/graphviz.hpp>
+#include <boost/unordered_map.hpp>
 
 using namespace std;
 
+#include "Form.hpp"
+
 // Defining the graph vertices
-typedef boost::dynamic_bitset<> graphVertex; // form which can be either a
-                                             // starting form or the reached
-                                             // form after mitose
+typedef Form graphVertex; // form which can be either a starting form or the
+                          // reached form after mitose
 
 // Defining the graph edges properties
 struct graphEdge {
@@ -43,8 +46,14 @@ typedef boost::adjacency_list< boost::vecS, boost::vecS, boost::directedS,
 typedef boost::graph_traits< Graph >::vertex_iterator vertex_iter;
 typedef Graph::vertex_descriptor Vertex;
 
+// Normalized translations of the stored forms, each one giving the first
+// vertex stored with it
+typedef boost::unordered_map< graphVertex, unsigned int > TranslationIndex;
+
 using namespace std;
 
+struct RowBoard; // see FormTransform.hpp
+
 class Environment
 {
 
@@ -56,62 +65,84 @@ public:
   unsigned int getMaxCell(); // Get the maximum number of cells sought
   unsigned int getWidth();
   unsigned int getHeight();
-  boost::dynamic_bitset<> ror(boost::dynamic_bitset<> transForm,
-                              unsigned int nbBits); // Allow to make shift and
-                                                    // rotate operations on the
-                                                    // dynamic bitset for shape
-                                                    // translation
+  graphVertex
+  normalizeTranslation(const graphVertex &form); // Shift the form
+                                                             // to the top left
+                                                             // corner of its
+                                                             // bounding box
+  void indexTranslation(TranslationIndex &index, const graphVertex &form,
+                        unsigned int vertex); // Store the normalized
+                                              // translation of a form
+  void indexTranslations(const Graph &g, const vector< unsigned int > &vertices,
+                         TranslationIndex &index); // Store the normalized
+                                                   // translations of the
+                                                   // referenced forms
   unsigned int
-  findCentroid(boost::dynamic_bitset<> form, boost::dynamic_bitset<> &oneBit,
-               unsigned int &pos); // return the centroid of the form
-  unsigned int translationResult(Graph g, vector< unsigned int > vertices,
-                                 boost::dynamic_bitset<> form); // Give the
-                                                                // result of all
-                                                                // possible
-                                                                // translation
-                                                                // of the given
-                                                                // form in the
-                                                                // grid
+  translationResult(const TranslationIndex &index,
+                    const graphVertex &form); // Give the result of all
+                                              // possible translation of the
+                                              // given form in the grid
   unsigned int rotation270Result(
-      boost::dynamic_bitset<> &form,
-      unsigned int centroidPos); // Rotating the form through 270 degrees
+      graphVertex &form); // Rotating the form through 270 degrees
   unsigned int rotation180Result(
-      boost::dynamic_bitset<> &form,
-      unsigned int centroidPos); // Rotating the form through 180 degrees
+      graphVertex &form); // Rotating the form through 180 degrees
   unsigned int
-  rotation90Result(boost::dynamic_bitset<> &form,
-                   unsigned int centroidPos); // Rotating the form through 90
+  rotation90Result(graphVertex &form); // Rotating the form through
+                                                   // 90 degrees
   unsigned int horSymResult(
-      boost::dynamic_bitset<> &form,
-      unsigned int centroidPos); // Find the horizontal symmetry of the form
+      graphVertex &form); // Find the horizontal symmetry of the form
   unsigned int vertSymResult(
-      boost::dynamic_bitset<> &form,
-      unsigned int centroidPos); // Find the vertical symmetry of the form
-  unsigned int geomTransResult(Graph g, vector< unsigned int > vertices,
-                               boost::dynamic_bitset<> form,
-                               unsigned int (Environment::*geomTrans)(
-                                   boost::dynamic_bitset<> &, unsigned int));
+      graphVertex &form); // Find the vertical symmetry of the form
+  unsigned int
+  geomTransResult(const TranslationIndex &index, graphVertex form,
+                  unsigned int (Environment::*geomTrans)(
+                      graphVertex &));
+  graphVertex canonicalForm(const graphVertex &form); // Reduce a form to a key
+                                                      // shared by all its
+                                                      // translations, rotations
+                                                      // and symmetries
+  graphVertex canonicalForm(const graphVertex &form,
+                            unsigned int &symmetry); // canonicalForm, giving
+                                                     // the Symmetry of the form
+                                                     // which is the key
   unsigned int
-  existInGraph(Graph g, boost::dynamic_bitset<> form,
-               vector< unsigned int > vertices); // Verify If a grid
-                                                 // of a same number
-                                                 // of cells already
-                                                 // exists or its
-                                                 // translation or
-                                                 // rotation
-  void setForm(boost::dynamic_bitset<> form,
+  existInGraph(const TranslationIndex &index,
+               const graphVertex &form); // Verify If a grid of a same
+                                         // number of cells already exists
+                                         // or its translation or rotation
+  void setForm(graphVertex form,
                vector< unsigned int > positions); // Starting the reachable sets
                                                   // generation with a fo
-  bool mitose(boost::dynamic_bitset<> &form, unsigned int motherPosition,
+  bool mitose(graphVertex &form, unsigned int motherPosition,
               char direction); // Trigger a mitose
-  void
-  display(boost::dynamic_bitset<> form,
-          unsigned int formLabel); // Display the final grids on a external file
+  graphVertex mitoseMask(const graphVertex &form,
+                         char direction); // Find at once all the cells of the
+                                          // form which can trigger a mitose
+                                          // with the given control
+  unsigned int daughterPosition(unsigned int motherPosition,
+                                char direction); // Position of the cell created
+                                                 // by a mitose
 private:
+  unsigned int symmetryResult(graphVertex &form,
+                              int sym); // Apply one of the symmetries of
+                                        // FormTransform.hpp to the form
+  graphVertex canonicalFormByCells(
+      const graphVertex &form,
+      unsigned int &symmetry); // canonicalForm for forms too large for a
+                                // RowBoard
+  bool loadFormBoard(const graphVertex &form,
+                     RowBoard &board); // loadBoard with the kernel
+                                       // specialized for the grid size if any
+  bool (*_loadBoard)(const graphVertex &,
+                     RowBoard &); // specialized loadBoard, NULL if none
+  void (*_storeKey)(const RowBoard &,
+                    graphVertex &); // specialized key writer, NULL if none
   string _shape;         // the sought shape
   unsigned int _maxCell; // maximum number of cells wished
   unsigned int _height;  // max height of forms
   unsigned int _width;   // max height of forms
+  graphVertex _notFirstCol; // every cell of the grid but the first column
+  graphVertex _notLastCol;  // every cell of the grid but the last column
 };
 
 #endif // ENVIRONMENT_H_INCLUDED
@@ -3,109 +3,97 @@
 /// \author A. Sarr
 /// \version 1.0
 /// \date 24 mai 2013
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/archive/text_iarchive.hpp>
-#include <boost/serialization/bitset.hpp>
-#include <boost/graph/adj_list_serialize.hpp>
-#include <boost/serialization/vector.hpp>
-
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <vector>
-#include <numeric>
-#include <algorithm>
 
 //#include <C:/Users/info/Desktop/Viab-Cell/environment.h>
 #include "environment.h"
+#include "EnumerationEngine.hpp"
+#include "FormWriter.hpp"
 #include "Graphics.hpp"
-#include "GraphManager.hpp"
-
-struct A {
-    boost::dynamic_bitset<> x;
-  private:
-    friend class boost::serialization::access;
-    template <class Archive> void serialize(Archive &ar, const unsigned int) { 
-        ar &x; 
-    }
-};
-
-namespace boost { namespace serialization {
-
-    template <typename Ar, typename Block, typename Alloc>
-        void save(Ar& ar, dynamic_bitset<Block, Alloc> const& bs, unsigned) {
-            size_t num_bits = bs.size();
-            std::vector<Block> blocks(bs.num_blocks());
-            to_block_range(bs, blocks.begin());
-
-            ar & num_bits & blocks;
-        }
-
-    template <typename Ar, typename Block, typename Alloc>
-        void load(Ar& ar, dynamic_bitset<Block, Alloc>& bs, unsigned) {
-            size_t num_bits;
-            std::vector<Block> blocks;
-            ar & num_bits & blocks;
-
-            bs.resize(num_bits);
-            from_block_range(blocks.begin(), blocks.end(), bs);
-            bs.resize(num_bits);
-        }
-
-    template <typename Ar, typename Block, typename Alloc>
-        void serialize(Ar& ar, dynamic_bitset<Block, Alloc>& bs, unsigned version) {
-            split_free(ar, bs, version);
-        }
+#include "Instrumentation.hpp"
+#include "ResultStore.hpp"
+#include "Trace.hpp"
 
-} }
-
-int main()
+// Print the timesteps as they are expanded
+class ProgressVisitor : public EnumerationVisitor
 {
+public:
+  void startTimestep(unsigned int timestep)
+  {
+    if (timestep > 0) std::cout << "timestep :" << timestep - 1 << std::endl;
+  }
+};
 
-  // Count the number of vertices added in each timestep
-  unsigned int countVerticesPerTime;
+// Write the counters of each timestep to a log, see Instrumentation.hpp
+class InstrumentationVisitor : public EnumerationVisitor
+{
+public:
+  explicit InstrumentationVisitor(std::ostream &log) : _log(log) {}
 
-  // record each timestep's number of vertices
-  std::vector< unsigned int > verticesPerTimestep;
+  void finishTimestep(unsigned int timestep, std::size_t /*nbForms*/)
+  {
+    Instrumentation::dump(_log, timestep);
+  }
 
-  // Map regrouping same number of cells vertices
-  std::map<unsigned int, std::vector<unsigned int> > verticesPerNbCell;
+private:
+  std::ostream &_log;
+};
 
-  Graph g;               // defining a graph
+int main(int argc, char *argv[])
+{
+  EnumerationConfig config;
   // dimension of the env
-  std::vector<int> dim(3);
-  dim[0] = 10;
-  dim[1] = 10;
-  dim[2] = 1;
+  config.width = 10;
+  config.height = 10;
   // type of the cell simulated : true if healthy, false if cancerous
-  bool healthy = false;
+  config.healthy = false;
   // initial resources for a cell mitosis
-  double initEneLvl=0, initOxyLvl=6, initGluLvl=18, initLacLvl=0;
-  // define a graph manager
-  GraphManager gm(dim, g,
-      initEneLvl, initOxyLvl, initGluLvl, initLacLvl,
-      1, 6, 36, 2, 2, 40,
-      1, 1, 4, 2, 90,
-      36);
-  unsigned int timestep; // Records the timesteps
+  config.initEne = 0;
+  config.initOxy = 6;
+  config.initGlu = 18;
+  config.initLac = 0;
+  // storage of the env saved with each form, FLOAT_PRECISION or FIXED_POINT
+  // divide its memory by 2 or 4
+  config.precision = DOUBLE_PRECISION;
+  // true to save only the forms and recompute their env when it is read,
+  // the last envCacheSize env read being kept
+  config.lazyEnv = false;
+  config.envCacheSize = 64;
 
   //  unsigned int bridgeTime4 = 3; //Defining the time of crossing constraints
   //  after three divisions
   //  unsigned int bridgeTime8 = 7; //Defining the time of crossing constraints
   //  after seven divisions
 
-  unsigned int firstPos = 55; // Specify the first cell's position
+  config.firstPos = 55; // Specify the first cell's position
+
+  config.maxCell = 7; // Defining the max cells to reach for final forms
 
-  unsigned int maxCell = 7; // Defining the max cells to reach for final forms
+  // Expand the forms of a timestep on every core, by batches of parents so
+  // that the memory used by the expansions stays bounded
+  config.nbThreads = 0; // every core
+  config.batchSize = 4096;
 
-  // Dimensions of the grid
-  unsigned int width = 10;
-  unsigned int height = 10;
+  // Memory in bytes for the children of a timestep, beyond which they are
+  // sorted to run files in spillDirectory and deduplicated by merging the
+  // runs. 0 deduplicates them in memory with the form index.
+  config.memoryBudget = 0;
+  config.spillDirectory = ".";
 
-  // Maximum size of forms
-  unsigned int maxSize = width * height;
+  // Result store to which each timestep is added on a background thread
+  // while the next one is expanded, to resume the run from it if it stops.
+  // Empty to save the result only once the enumeration is done.
+  config.checkpointName = "saved.bin";
 
-  Environment *env;
-  env = new Environment(maxCell, height, width);
+  // Layout of formFile and graphFile : TEXT_FORMAT as grids, COMPACT_FORMAT
+  // with a line per form or BINARY_FORMAT
+  FormFileFormat formFormat = TEXT_FORMAT;
+
+  unsigned int width = config.width;
+  unsigned int height = config.height;
 
   Graph catalog; // The graph which contains the catalog of forms with which
                  // forms have to be assessed in given timestep
@@ -157,233 +145,50 @@ int main()
   // Output the config of the simulation
   cout << "######## CONFIG ########" << endl << endl;
   cout << "* LENGTH : " << width << " x " << height << endl << endl;
-  cout << "* STARTING POSITION : " << firstPos << endl << endl;
-  cout << "* MAX CELL NUMBER : " << maxCell << endl << endl << endl;
+  cout << "* STARTING POSITION : " << config.firstPos << endl << endl;
+  cout << "* MAX CELL NUMBER : " << config.maxCell << endl << endl << endl;
   cout << "######## RESULTS ########" << endl << endl;
 
-  char directions[4] = {
-      'u', 'd', 'r',
-      'l'}; // The controls which indicates th direction of mitosis
-
-  boost::dynamic_bitset<> formContainer(maxSize, 0); // The starting form
+  ProgressVisitor progress;
+  EnumerationEngine engine(config);
+  engine.addVisitor(&progress);
+
+  // The counters of the hot paths, when compiled in, one JSON object per
+  // timestep
+  std::ofstream instrumentationLog;
+  InstrumentationVisitor instrumentation(instrumentationLog);
+  if (Instrumentation::isEnabled()) {
+    instrumentationLog.open("instrumentation.log", ios::out);
+    engine.addVisitor(&instrumentation);
+  }
 
-  formContainer.set(firstPos); // set position
+  // A result saved by a previous run, given as first argument, is continued
+  // from its last timestep : an interrupted run is resumed and a finished run
+  // is extended to maxCell without computing its timesteps again
+  if (argc > 1) {
+    try {
+      engine.resume(argv[1]);
+    } catch (const std::exception &e) {
+      cerr << e.what() << endl;
+      return EXIT_FAILURE;
+    }
+    cout << "* RESUMED AT TIMESTEP : " << engine.getTimestep() << endl << endl;
+  }
 
+  try {
+    engine.run();
+  } catch (const std::exception &e) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
 
-  timestep = 0;
+  const GraphManager &gm = engine.getGraphManager();
+  const std::vector< unsigned int > &verticesPerTimestep =
+    engine.getVerticesPerTimestep();
+  unsigned int timestep = engine.getTimestep();
 
   // Allow to retrieve graph's vertices and iterate on them
   pair< vertex_iter, vertex_iter > vertexPair, vertexPair_prev;
-  pair< vertex_iter, vertex_iter > EvertexPair, EvertexPair_prev;
-  pair< vertex_iter, vertex_iter > OvertexPair, OvertexPair_prev;
-  pair< vertex_iter, vertex_iter > GvertexPair, GvertexPair_prev;
-  pair< vertex_iter, vertex_iter > LvertexPair, LvertexPair_prev;
-
-  // Add the starting form to the graph ! This form will represent the root
-  //boost::add_vertex(formContainer, g);
-  
-  std::vector<double> energy(maxSize, initEneLvl);
-  std::vector<double> oxygen(maxSize, initOxyLvl);
-  std::vector<double> glucose(maxSize, initGluLvl);
-  std::vector<double> lactate(maxSize, initLacLvl);
-  gm.add_vertexToGForm(formContainer, energy, oxygen, glucose, lactate);
-
-  // Record the reference of the vertex among those of the same number of cell
-  verticesPerNbCell[formContainer.count()].push_back(gm.getMaxNbrOfForm() - 1);
-
-  // At initial time 0 we have just one node corresponding to the root
-  verticesPerTimestep.push_back(1);
-
-  // Loop until getting all recheable forms with the right number of cells
-  while (timestep + 1 < maxCell) {
-    std::cout << "timestep :" << timestep << std::endl;
-    //std::cout << "countVerticesPerTime : " << countVerticesPerTime << std::endl;
-    // Initialize the number of vertices in the current timestep
-    //if(countVerticesPerTime == 0) timestep = std::max(((int)timestep)-1, 0);
-    countVerticesPerTime = 0;
-
-    vertexPair_prev = vertices(gm.getGForm());
-    EvertexPair_prev = vertices(gm.getGEnergy());
-    OvertexPair_prev = vertices(gm.getGOxygen());
-    GvertexPair_prev = vertices(gm.getGGlucose());
-    LvertexPair_prev = vertices(gm.getGLactate());
-
-    timestep++;
-
-    unsigned int nbVertices = 0;
-
-    
-    // Loop until each node of previous timestep is processed
-    while (nbVertices < verticesPerTimestep[timestep - 1]) {
-      //std::cout << "nbVertices  : " << nbVertices<< std::endl;
-      // Iterate within the nodes of previous timestep
-      --vertexPair_prev.second;
-      --EvertexPair_prev.second;
-      --OvertexPair_prev.second;
-      --GvertexPair_prev.second;
-      --LvertexPair_prev.second;
-
-      // Form in the current node to be processed
-      boost::dynamic_bitset<> form = gm.getGForm()[*vertexPair_prev.second];
-      // initialize resources for a form
-      gm.init_ressource(energy, oxygen, glucose, lactate, form);
-
-      unsigned int nbCells = form.count();
-      unsigned int formSize = 0;
-
-      unsigned int motherPosition = 0;
-
-      // do healthy or cancerous reaction
-      while (motherPosition < maxSize) {
-        if (form[motherPosition]) {
-          if (healthy)
-          {
-            gm.healthy_reaction(
-                energy,
-                oxygen,
-                glucose,
-                lactate,
-                motherPosition);
-          }else{
-            gm.cancerous_reaction(
-                energy,
-                oxygen,
-                glucose,
-                lactate,
-                motherPosition);
-          }
-          //std::cout << "energy at pos " << motherPosition << ":" << energy[motherPosition] << std::endl;
-        }
-        motherPosition++;
-      }
-      //gm.getGEnergy()[*EvertexPair_prev.second] = energy;
-      //gm.getGOxygen()[*OvertexPair_prev.second] = oxygen;
-      //gm.getGGlucose()[*GvertexPair_prev.second] = glucose;
-      //gm.getGLactate()[*LvertexPair_prev.second] = lactate;
-      motherPosition=0;
-      // Process each cell of the form
-      while ((motherPosition < maxSize) && (formSize < nbCells)) {
-        // If there is a cell in the position c
-        if (form[motherPosition]) {
-          formSize++;
-
-          // For each cell, try each mitosis control to divide
-          for (int d = 0; d < 4; d++) {
-            // Try to trigger a mitosis of the current cell with the current
-            // control within the current form
-            boost::dynamic_bitset<> mitoForm = form;
-            bool mitose = env->mitose(mitoForm, motherPosition, directions[d]);
-
-            // Calculating the subset of reachable sets or enforcing the some
-            // crossing constraints
-            // At the time of crossing constraints, compare in an automated way
-            // (rather than by the user) the reached forms to the forms of the
-            // catalog defined at the beginning
-            // then continuing with the corresponding ones
-
-            // First crossing constraints
-            //                      if((timestep == bridgeTime4) && mitose)
-            //                      {
-            //                          unsigned int inCatalog =
-            //                          env->existInGraph(catalog,mitoForm,formCatalog4);
-            //                          if(!inCatalog)
-            //                          mitose = false;
-            //                      }
-            //
-
-            // Second crossing constraints
-            //                      if((timestep == bridgeTime8) && mitose)
-            //                      {
-            //                          unsigned int inCatalog =
-            //                          env->existInGraph(catalog,mitoForm,formCatalog8);
-            //                          if(!inCatalog)
-            //                          mitose = false;
-            //                      }
-
-            // If a mitosis is achieved
-            // check if a mitosis can be done
-            if(mitose) {
-              mitose = gm.canMitose(
-                  motherPosition,
-                  directions[d],
-                  dim,
-                  energy,
-                  lactate,
-                  healthy);
-            }
-            
-            if (mitose) {
-              unsigned int newNbCells = mitoForm.count();
-
-              unsigned int vertex;
-
-              // If there are already forms of same number of cells as the newly
-              // generated form,
-              // test if there is any redundance, also with geometrical
-              // transformation
-              if (verticesPerNbCell[newNbCells].size() != 0)
-                vertex = env->existInGraph(gm.getGForm(), mitoForm,
-                                           verticesPerNbCell[newNbCells]);
-              else
-                vertex = 0;
-              // do not check if form already exist
-              //vertex = 0;
-
-              // If there is no redundance
-              if (vertex == 0) {
-                // Add the wewly created form in the graph
-                //Vertex formVertex = boost::add_vertex(mitoForm, g);
-                // Add the newly created form in the form graph and save the env
-                Vertex formVertex = gm.add_vertexToGForm(mitoForm,
-                    energy, oxygen, glucose, lactate);
-
-                // In the map, record the reference of the vertex among those of
-                // the same number of cell
-                verticesPerNbCell[newNbCells].push_back(gm.getMaxNbrOfForm() - 1);
-
-                // Define an edge that link the two vertices and add properties
-                graphEdge firstEdge;
-
-                firstEdge.Control = directions[d];
-                firstEdge.Mitoser = motherPosition;
-                firstEdge.Temps = timestep;
-
-                // link the two vertices
-                //add_edge(*vertexPair_prev.second, formVertex, firstEdge, g);
-                gm.add_edgeToGForm(*vertexPair_prev.second, formVertex, firstEdge);
-
-                // Increment the number of added vertices in the current
-                // timestep
-                countVerticesPerTime++;
-              }
-
-              // If the newly created form already exist in the graph
-              else {
-                // Find among the added vertices which one represent the newly
-                // created form
-                // If founded, create just a new edge
-
-                graphEdge anotherEdge;
-                anotherEdge.Control = directions[d];
-                anotherEdge.Mitoser = motherPosition;
-                anotherEdge.Temps = timestep;
-
-                //add_edge(*vertexPair_prev.second, vertex, anotherEdge, g);
-                gm.add_edgeToGForm(*vertexPair_prev.second, vertex, anotherEdge);
-              }
-            }
-          }
-        }
-
-        motherPosition++;
-      }
-
-      nbVertices++;
-    }
-
-    // record the total number of nodes added at the current timestep
-    verticesPerTimestep.push_back(countVerticesPerTime);
-  }
 
   // Output results
   cout << "REACHED SETS : " << endl << endl;
@@ -392,12 +197,13 @@ int main()
 
   vertexPair_prev = vertices(gm.getGForm());
 
+  // formFile and graphFile are written on a background thread, through
+  // buffered files, while the results are saved
+  FormWriter formWriter("formFile", "graphFile", width, height, formFormat);
+
   //  Displaying results on an external file
   for (unsigned int last = 0; last < verticesPerTimestep[timestep]; last++)
-    env->display(gm.getGForm()[*--vertexPair_prev.second], last + 1);
-
-  // free allocated memories
-  delete env;
+    formWriter.addFinalForm(gm.getForm(*--vertexPair_prev.second), last + 1);
 
   // Output graph
 
@@ -419,45 +225,51 @@ int main()
   // 3rd method
   // Output all created form according to the graph structure
 
-    ofstream graphFile;
-    graphFile.open("graphFile", ios::out);
-    if (graphFile.bad()){ cerr << "Impossible d'ouvrir le fichier !" << endl;}
-  
     unsigned int t = 0;
     vertexPair = vertices(gm.getGForm());
     while(t <= timestep)
     {
         for(unsigned int step = 0; step < verticesPerTimestep[t]; step++)
         {
-            graphFile<<gm.getGForm()[*vertexPair.first]<<"     ";
+            formWriter.addForm(gm.getForm(*vertexPair.first));
             ++vertexPair.first;
         }
         t++;
-        graphFile<<endl<<endl<<endl;
+        formWriter.endTimestep();
     }
 
-  // the gm class can be saved with boost::serialize
-  const char* fileName = "saved.txt"; 
-  {
-  // Create an output archive
-  std::ofstream ofs(fileName);
-  boost::archive::text_oarchive ar(ofs);
-
-  // Write data
-  ar & gm;
+  // The results in a binary store, viewed in place through a mapping
+  std::string fileName = config.checkpointName;
+  if (fileName.empty()) {
+    fileName = "saved.bin";
+    saveResultStore(fileName, gm, verticesPerTimestep, height, width,
+        config.healthy);
   }
-  std::ifstream ifs(fileName);
-  boost::archive::text_iarchive ia(ifs);
-  GraphManager gm2;
-  ia >> gm2;
+  ResultStore store(fileName);
+
+  if (!formWriter.close())
+    std::cerr << "Impossible d'ecrire dans le fichier !" << std::endl;
+
+  // The timeline of the run, written again with the forms loaded by the
+  // viewer once it is closed
+  if (Instrumentation::isEnabled()) Trace::write("trace.json");
 
   std::vector<double> bgColor(3);
   bgColor[0] = .2;
   bgColor[1] = .3;
   bgColor[2] = .4;
-  GraphViewer gv = GraphViewer(gm2, bgColor, dim);
-  gv.Render();
-  gv.Start();
+  std::vector<int> dim(3);
+  dim[0] = width;
+  dim[1] = height;
+  dim[2] = 1;
+  {
+    // the viewer loads forms on a thread of its own, which is stopped with
+    // it before the trace is written
+    GraphViewer gv(store, bgColor, dim);
+    gv.Render();
+    gv.Start();
+  }
+  if (Instrumentation::isEnabled()) Trace::write("trace.json");
 
   return EXIT_SUCCESS;
 }